@@ -89,12 +89,24 @@ Castro::wd_update (Real time, Real dt)
     Real old_mass_P = mass_P;
     Real old_mass_S = mass_S;
 
+    // All of the stellar quantities are accumulated in a single fused
+    // pass over each level: every zone is classified by the effective
+    // potential of the two stars (see stellar_mask), and then contributes
+    // to that star's mass, center of mass, momentum, and to its volume
+    // at each of the density cutoffs 10**0 through 10**6 used for the
+    // effective radii. The derived primarymask/secondarymask fields are
+    // not used here so that we do not need a separate pass for each.
+
     ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum,
               ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum,
-              ReduceOpSum, ReduceOpSum> reduce_op;
+              ReduceOpSum, ReduceOpSum,
+              ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum,
+              ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_op;
     ReduceData<Real, Real, Real, Real, Real, Real,
                Real, Real, Real, Real, Real, Real,
-               Real, Real> reduce_data(reduce_op);
+               Real, Real,
+               Real, Real, Real, Real, Real, Real, Real,
+               Real, Real, Real, Real, Real, Real, Real> reduce_data(reduce_op);
     using ReduceTuple = typename decltype(reduce_data)::Type;
 
     for (int lev = 0; lev <= parent->finestLevel(); lev++) {
@@ -103,7 +115,6 @@ Castro::wd_update (Real time, Real dt)
 
       GeometryData geomdata = c_lev.geom.data();
 
-      const auto dx = c_lev.geom.CellSizeArray();
       const auto problo = c_lev.geom.ProbLoArray();
       const auto probhi = c_lev.geom.ProbHiArray();
       int coord_type = c_lev.geom.Coord();
@@ -120,48 +131,30 @@ Castro::wd_update (Real time, Real dt)
           }
       }
 
-      // Density and momenta
-
-      auto mfrho  = c_lev.derive("density",time,0);
-      auto mfxmom = c_lev.derive("xmom",time,0);
-      auto mfymom = c_lev.derive("ymom",time,0);
-      auto mfzmom = c_lev.derive("zmom",time,0);
+      // We read the conserved state and the rotational potential directly;
+      // the levels are synchronized at this point, so the new-time data
+      // is the data at the current time.
 
-      // Masks for the primary and secondary
+      const MultiFab& S_lev = c_lev.get_new_data(State_Type);
+      const MultiFab& phirot_lev = c_lev.get_new_data(PhiRot_Type);
 
-      auto mfpmask = c_lev.derive("primarymask", time, 0);
-      auto mfsmask = c_lev.derive("secondarymask", time, 0);
+      // Zones covered by a finer level are zeroed out by the fine mask.
 
-      BL_ASSERT(mfrho   != nullptr);
-      BL_ASSERT(mfxmom  != nullptr);
-      BL_ASSERT(mfymom  != nullptr);
-      BL_ASSERT(mfzmom  != nullptr);
-      BL_ASSERT(mfpmask != nullptr);
-      BL_ASSERT(mfsmask != nullptr);
-
-      if (lev < parent->finestLevel())
-      {
-          const MultiFab& mask = getLevel(lev+1).build_fine_mask();
-
-          MultiFab::Multiply(*mfrho,   mask, 0, 0, 1, 0);
-          MultiFab::Multiply(*mfxmom,  mask, 0, 0, 1, 0);
-          MultiFab::Multiply(*mfymom,  mask, 0, 0, 1, 0);
-          MultiFab::Multiply(*mfzmom,  mask, 0, 0, 1, 0);
-          MultiFab::Multiply(*mfpmask, mask, 0, 0, 1, 0);
-          MultiFab::Multiply(*mfsmask, mask, 0, 0, 1, 0);
-      }
+      const bool has_fine_mask = lev < parent->finestLevel();
+      const MultiFab* fine_mask = has_fine_mask ? &(getLevel(lev+1).build_fine_mask()) : nullptr;
 
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-      for (MFIter mfi(*mfrho, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-          auto rho   = (*mfrho )[mfi].array();
-          auto xmom  = (*mfxmom)[mfi].array();
-          auto ymom  = (*mfymom)[mfi].array();
-          auto zmom  = (*mfzmom)[mfi].array();
-          auto pmask = (*mfpmask)[mfi].array();
-          auto smask = (*mfsmask)[mfi].array();
-          auto vol   = c_lev.volume[mfi].array();
+      for (MFIter mfi(S_lev, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+          auto state  = S_lev[mfi].array();
+          auto phirot = phirot_lev[mfi].array();
+          auto vol    = c_lev.volume[mfi].array();
+
+          Array4<Real const> fmask;
+          if (has_fine_mask) {
+              fmask = fine_mask->const_array(mfi);
+          }
 
           const Box& box  = mfi.tilebox();
 
@@ -186,6 +179,29 @@ Castro::wd_update (Real time, Real dt)
               GpuArray<Real, 3> r;
               position(i, j, k, geomdata, r);
 
+              Real rho = state(i,j,k,URHO);
+
+              Real primary_factor = 0.0_rt;
+              Real secondary_factor = 0.0_rt;
+
+              int star = stellar_mask(r, rho, phirot(i,j,k));
+
+              if (star == 1) {
+
+                  primary_factor = 1.0_rt;
+
+              }
+              else if (star == 2) {
+
+                  secondary_factor = 1.0_rt;
+
+              }
+
+              if (has_fine_mask) {
+                  primary_factor *= fmask(i,j,k);
+                  secondary_factor *= fmask(i,j,k);
+              }
+
               // We account for symmetric boundaries in this sum as usual,
               // by adding to the position the locations that would exist
               // on the opposite side of the symmetric boundary. Note that
@@ -202,10 +218,10 @@ Castro::wd_update (Real time, Real dt)
                   }
               }
 
-              Real dm = rho(i,j,k) * vol(i,j,k);
+              Real dm = rho * vol(i,j,k);
 
               Real dmSymmetric = dm;
-              GpuArray<Real, 3> momSymmetric{xmom(i,j,k), ymom(i,j,k), zmom(i,j,k)};
+              GpuArray<Real, 3> momSymmetric{state(i,j,k,UMX), state(i,j,k,UMY), state(i,j,k,UMZ)};
 
               if (coord_type == 0) {
 
@@ -232,20 +248,6 @@ Castro::wd_update (Real time, Real dt)
 
               }
 
-              Real primary_factor = 0.0_rt;
-              Real secondary_factor = 0.0_rt;
-
-              if (pmask(i,j,k) > 0.0_rt) {
-
-                  primary_factor = 1.0_rt;
-
-              }
-              else if (smask(i,j,k) > 0.0_rt) {
-
-                  secondary_factor = 1.0_rt;
-
-              }
-
               Real com_P_x = dmSymmetric * rSymmetric[0] * primary_factor;
               Real com_P_y = dmSymmetric * rSymmetric[1] * primary_factor;
               Real com_P_z = dmSymmetric * rSymmetric[2] * primary_factor;
@@ -265,74 +267,86 @@ Castro::wd_update (Real time, Real dt)
               Real m_P = dmSymmetric * primary_factor;
               Real m_S = dmSymmetric * secondary_factor;
 
+              // Volume of the stars above each density cutoff, for the
+              // effective radii. Only zones within the Roche lobe of
+              // each white dwarf are counted.
+
+              Real dV_P[7] = {0.0_rt};
+              Real dV_S[7] = {0.0_rt};
+
+              Real rho_cutoff = 1.0_rt;
+
+              for (int n = 0; n <= 6; ++n) {
+                  if (rho > rho_cutoff) {
+                      dV_P[n] = vol(i,j,k) * primary_factor;
+                      dV_S[n] = vol(i,j,k) * secondary_factor;
+                  }
+                  rho_cutoff *= 10.0_rt;
+              }
+
               return {com_P_x, com_P_y, com_P_z, com_S_x, com_S_y, com_S_z,
                       vel_P_x, vel_P_y, vel_P_z, vel_S_x, vel_S_y, vel_S_z,
-                      m_P, m_S};
+                      m_P, m_S,
+                      dV_P[0], dV_P[1], dV_P[2], dV_P[3], dV_P[4], dV_P[5], dV_P[6],
+                      dV_S[0], dV_S[1], dV_S[2], dV_S[3], dV_S[4], dV_S[5], dV_S[6]};
           });
 
       }
 
     }
 
-    // Compute effective radii of stars at various density cutoffs
-
-    bool local_flag = true;
-
-    for (int i = 0; i <= 6; ++i)
-        Castro::volInBoundary(time, vol_P[i], vol_S[i], pow(10.0,i), local_flag);
-
-    // Do all of the reductions.
+    // Do all of the reductions. All 28 quantities are summed
+    // across ranks with a single collective.
 
     ReduceTuple hv = reduce_data.value();
 
-    com_P[0] = amrex::get<0>(hv);
-    com_P[1] = amrex::get<1>(hv);
-    com_P[2] = amrex::get<2>(hv);
-    com_S[0] = amrex::get<3>(hv);
-    com_S[1] = amrex::get<4>(hv);
-    com_S[2] = amrex::get<5>(hv);
-    vel_P[0] = amrex::get<6>(hv);
-    vel_P[1] = amrex::get<7>(hv);
-    vel_P[2] = amrex::get<8>(hv);
-    vel_S[0] = amrex::get<9>(hv);
-    vel_S[1] = amrex::get<10>(hv);
-    vel_S[2] = amrex::get<11>(hv);
-    mass_P   = amrex::get<12>(hv);
-    mass_S   = amrex::get<13>(hv);
-
     const int nfoo_sum = 28;
     Real foo_sum[nfoo_sum] = { 0.0 };
 
-    for (int i = 0; i <= 6; ++i) {
-      foo_sum[i  ] = vol_P[i];
-      foo_sum[i+7] = vol_S[i];
-    }
+    foo_sum[ 0] = amrex::get< 0>(hv);
+    foo_sum[ 1] = amrex::get< 1>(hv);
+    foo_sum[ 2] = amrex::get< 2>(hv);
+    foo_sum[ 3] = amrex::get< 3>(hv);
+    foo_sum[ 4] = amrex::get< 4>(hv);
+    foo_sum[ 5] = amrex::get< 5>(hv);
+    foo_sum[ 6] = amrex::get< 6>(hv);
+    foo_sum[ 7] = amrex::get< 7>(hv);
+    foo_sum[ 8] = amrex::get< 8>(hv);
+    foo_sum[ 9] = amrex::get< 9>(hv);
+    foo_sum[10] = amrex::get<10>(hv);
+    foo_sum[11] = amrex::get<11>(hv);
+    foo_sum[12] = amrex::get<12>(hv);
+    foo_sum[13] = amrex::get<13>(hv);
+    foo_sum[14] = amrex::get<14>(hv);
+    foo_sum[15] = amrex::get<15>(hv);
+    foo_sum[16] = amrex::get<16>(hv);
+    foo_sum[17] = amrex::get<17>(hv);
+    foo_sum[18] = amrex::get<18>(hv);
+    foo_sum[19] = amrex::get<19>(hv);
+    foo_sum[20] = amrex::get<20>(hv);
+    foo_sum[21] = amrex::get<21>(hv);
+    foo_sum[22] = amrex::get<22>(hv);
+    foo_sum[23] = amrex::get<23>(hv);
+    foo_sum[24] = amrex::get<24>(hv);
+    foo_sum[25] = amrex::get<25>(hv);
+    foo_sum[26] = amrex::get<26>(hv);
+    foo_sum[27] = amrex::get<27>(hv);
 
-    foo_sum[14] = mass_P;
-    foo_sum[15] = mass_S;
+    amrex::ParallelDescriptor::ReduceRealSum(foo_sum, nfoo_sum);
 
     for (int i = 0; i <= 2; ++i) {
-      foo_sum[i+16] = com_P[i];
-      foo_sum[i+19] = com_S[i];
-      foo_sum[i+22] = vel_P[i];
-      foo_sum[i+25] = vel_S[i];
+      com_P[i] = foo_sum[i  ];
+      com_S[i] = foo_sum[i+3];
+      vel_P[i] = foo_sum[i+6];
+      vel_S[i] = foo_sum[i+9];
     }
 
-    amrex::ParallelDescriptor::ReduceRealSum(foo_sum, nfoo_sum);
+    mass_P = foo_sum[12];
+    mass_S = foo_sum[13];
 
     for (int i = 0; i <= 6; ++i) {
-      vol_P[i] = foo_sum[i  ];
-      vol_S[i] = foo_sum[i+7];
-    }
-
-    mass_P = foo_sum[14];
-    mass_S = foo_sum[15];
-
-    for (int i = 0; i <= 2; ++i) {
-      com_P[i] = foo_sum[i+16];
-      com_S[i] = foo_sum[i+19];
-      vel_P[i] = foo_sum[i+22];
-      vel_S[i] = foo_sum[i+25];
+      vol_P[i] = foo_sum[i+14];
+      vol_S[i] = foo_sum[i+21];
     }
 
     // Compute effective WD radii
@@ -397,109 +411,6 @@ Castro::wd_update (Real time, Real dt)
 
 
 
-// This function uses the known center of mass of the two white dwarfs,
-// and given a density cutoff, computes the total volume of all zones
-// whose density is greater or equal to that density cutoff.
-// We also impose a distance requirement so that we only look
-// at zones that are within twice the original radius of the white dwarf.
-
-void Castro::volInBoundary (Real time, Real& vol_P, Real& vol_S, Real rho_cutoff, bool local)
-{
-    BL_PROFILE("Castro::volInBoundary()");
-
-    using namespace wdmerger;
-    using namespace problem;
-
-    BL_ASSERT(level == 0);
-
-    vol_P = 0.0;
-    vol_S = 0.0;
-
-    for (int lev = 0; lev <= parent->finestLevel(); lev++) {
-
-      Castro& c_lev = getLevel(lev);
-
-      const auto dx = c_lev.geom.CellSizeArray();
-      auto mf = c_lev.derive("density",time,0);
-
-      // Effective potentials of the primary and secondary
-
-      auto mfpmask = c_lev.derive("primarymask", time, 0);
-      auto mfsmask = c_lev.derive("secondarymask", time, 0);
-
-      BL_ASSERT(mf      != nullptr);
-      BL_ASSERT(mfpmask != nullptr);
-      BL_ASSERT(mfsmask != nullptr);
-
-      if (lev < parent->finestLevel())
-      {
-	  const MultiFab& mask = c_lev.getLevel(lev+1).build_fine_mask();
-	  MultiFab::Multiply(*mf,      mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfpmask, mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfsmask, mask, 0, 0, 1, 0);
-      }
-
-      ReduceOps<ReduceOpSum, ReduceOpSum> reduce_op;
-      ReduceData<Real, Real> reduce_data(reduce_op);
-      using ReduceTuple = typename decltype(reduce_data)::Type;
-
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-      for (MFIter mfi(*mf, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-          auto rho   = (*mf)[mfi].array();
-          auto pmask = (*mfpmask)[mfi].array();
-          auto smask = (*mfsmask)[mfi].array();
-          auto vol   = c_lev.volume[mfi].array();
-
-	  const Box& box  = mfi.tilebox();
-
-          // This function uses the known center of mass of the two white dwarfs,
-          // and given a density cutoff, computes the total volume of all zones
-          // whose density is greater or equal to that density cutoff.
-          // We also impose a distance requirement so that we only look
-          // at zones within the Roche lobe of the white dwarf.
-
-          reduce_op.eval(box, reduce_data,
-          [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
-          {
-              Real primary_factor = 0.0_rt;
-              Real secondary_factor = 0.0_rt;
-
-              if (rho(i,j,k) > rho_cutoff) {
-
-                  if (pmask(i,j,k) > 0.0_rt) {
-
-                      primary_factor = 1.0_rt;
-
-                  }
-                  else if (smask(i,j,k) > 0.0_rt) {
-
-                      secondary_factor = 1.0_rt;
-
-                  }
-
-              }
-
-              return {vol(i,j,k) * primary_factor, vol(i,j,k) * secondary_factor};
-          });
-
-      }
-
-      ReduceTuple hv = reduce_data.value();
-
-      vol_P += amrex::get<0>(hv);
-      vol_S += amrex::get<1>(hv);
-
-    }
-
-    if (!local)
-      amrex::ParallelDescriptor::ReduceRealSum({vol_P, vol_S});
-
-}
-
-
-
 // Computes standard dot-product of two three-vectors.
 
 Real Castro::dot_product(const Real a[], const Real b[]) {
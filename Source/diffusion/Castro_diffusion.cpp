@@ -15,9 +15,17 @@ Castro::construct_old_diff_source(MultiFab& source, MultiFab& state_in, Real tim
 
     const Real strt_time = ParallelDescriptor::second();
 
-    MultiFab TempDiffTerm(grids, dmap, 1, 0);
+    // Keep the old-time diffusion term around; the new-time source
+    // needs the same term to time center the update, and recomputing
+    // it would redo the conductivity evaluation and operator setup.
+
+    if (!old_temp_diff_term.ok()) {
+        old_temp_diff_term.define(grids, dmap, 1, 0);
+    }
 
-    add_temp_diffusion_to_source(source, state_in, TempDiffTerm, time);
+    add_temp_diffusion_to_source(source, state_in, old_temp_diff_term, time);
+
+    old_temp_diff_time = time;
 
     if (verbose > 1)
     {
@@ -50,12 +58,27 @@ Castro::construct_new_diff_source(MultiFab& source, MultiFab& state_old, MultiFa
 
     add_temp_diffusion_to_source(source, state_new, TempDiffTerm, time, mult_factor);
 
-    // Time center the source term.
+    // Time center the source term. The old-time term is normally
+    // still cached from construct_old_diff_source; the diffusion term
+    // is filled from the state data at the requested time, so it is
+    // the same as it was then.
 
     mult_factor = -0.5;
     Real old_time = time - dt;
 
-    add_temp_diffusion_to_source(source, state_old, TempDiffTerm, old_time, mult_factor);
+    if (old_temp_diff_time >= 0.0 && old_temp_diff_term.ok() &&
+        std::abs(old_temp_diff_time - old_time) <= 1.e-12_rt * dt) {
+
+        if (diffuse_temp == 1) {
+            MultiFab::Saxpy(source, mult_factor, old_temp_diff_term, 0, UEDEN, 1, 0);
+            MultiFab::Saxpy(source, mult_factor, old_temp_diff_term, 0, UEINT, 1, 0);
+        }
+
+    } else {
+
+        add_temp_diffusion_to_source(source, state_old, TempDiffTerm, old_time, mult_factor);
+
+    }
 
     if (verbose > 1)
     {
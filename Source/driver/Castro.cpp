@@ -5,6 +5,7 @@
 #include <iomanip>
 
 #include <algorithm>
+#include <numeric>
 #include <cstdio>
 #include <vector>
 #include <iostream>
@@ -15,6 +16,7 @@
 #include <AMReX_CONSTANTS.H>
 #include <Castro.H>
 #include <Castro_F.H>
+#include <Castro_util.H>
 #include <Castro_error_F.H>
 #include <runtime_parameters.H>
 #include <AMReX_VisMF.H>
@@ -22,6 +24,7 @@
 #include <AMReX_FillPatchUtil.H>
 #include <AMReX_ParmParse.H>
 #include <extern_parameters_F.H>
+#include <perf_counters.H>
 
 #ifdef RADIATION
 #include <Radiation.H>
@@ -44,6 +47,12 @@
 #include <omp.h>
 #endif
 
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+#include <sys/mman.h>
+#include <mutex>
+#include <unordered_map>
+#endif
+
 #ifdef AMREX_USE_CUDA
 #include <cuda_profiler_api.h>
 #endif
@@ -67,6 +76,59 @@
 
 using namespace amrex;
 
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+namespace {
+
+// An arena that maps every allocation straight from the OS and unmaps
+// it on free. Unlike the caching arenas of AMReX it never hands back
+// pages that were already touched, so their NUMA placement is decided
+// by whoever touches them first.
+
+class FreshPageArena
+    : public Arena
+{
+public:
+
+    void* alloc (std::size_t sz) override
+    {
+        void* p = mmap(nullptr, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            amrex::Abort("FreshPageArena: mmap failed");
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sizes[p] = sz;
+
+        return p;
+    }
+
+    void free (void* p) override
+    {
+        if (p == nullptr) {
+            return;
+        }
+
+        std::size_t sz = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_sizes.find(p);
+            AMREX_ALWAYS_ASSERT(it != m_sizes.end());
+            sz = it->second;
+            m_sizes.erase(it);
+        }
+
+        munmap(p, sz);
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::unordered_map<void*, std::size_t> m_sizes;
+};
+
+}
+#endif
+
 bool         Castro::signalStopJob = false;
 
 std::vector<std::string> Castro::err_list_names;
@@ -81,6 +143,13 @@ Real         Castro::lastDtBeforePlotLimiting = 0.0;
 
 Real         Castro::num_zones_advanced = 0.0;
 
+Array<int, num_retry_causes> Castro::num_retries = {0};
+Real         Castro::retry_wall_time = 0.0;
+int          Castro::num_predictive_dt_limits = 0;
+
+Vector<Real> Castro::level_work_time;
+Vector<int>  Castro::level_num_regions;
+
 Vector<std::string> Castro::source_names;
 
 Vector<AMRErrorTag> Castro::custom_error_tags;
@@ -143,6 +212,8 @@ IntVect      Castro::hydro_tile_size(1048576,1048576,1048576);
 IntVect      Castro::no_tile_size(1024,1024,1024);
 #endif
 
+Vector<std::array<TileAutotuner, num_tile_families> > Castro::tile_autotuners;
+
 // this will be reset upon restart
 Real         Castro::previousCPUTimeUsed = 0.0;
 
@@ -353,6 +424,10 @@ Castro::read_params ()
       amrex::Error("Invalid CFL factor; must be between zero and one.");
     }
 
+    if (lightweight_passives == 1 && cfl > 1.0 / AMREX_SPACEDIM) {
+      amrex::Error("castro.lightweight_passives = 1 has no transverse corrections and requires cfl <= 1 / dim");
+    }
+
     // SDC does not support CUDA yet
 #ifdef AMREX_USE_GPU
     if (time_integration_method == SpectralDeferredCorrections) {
@@ -471,6 +546,15 @@ Castro::read_params ()
 
    StateDescriptor::setBndryFuncThreadSafety(bndry_func_thread_safe);
 
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+   // First touch placement only pays off if the threads stay on the
+   // cores (and so the NUMA nodes) they started on.
+   if (numa_first_touch == 1 && omp_get_proc_bind() == omp_proc_bind_false) {
+       amrex::Print() << "Warning: castro.numa_first_touch is set but OpenMP threads are not bound;"
+                      << " set OMP_PROC_BIND and OMP_PLACES (e.g. OMP_PROC_BIND=spread, OMP_PLACES=cores)" << std::endl;
+   }
+#endif
+
    // Open up Castro data logs
    // Note that this functionality also exists in the Amr class
    // but we implement it on our own to have a little more control.
@@ -521,6 +605,21 @@ Castro::read_params ()
         }
     }
 
+    // First touch relies on every loop giving each thread the same
+    // tiles, so the tile shape has to stay fixed.
+
+    if (numa_first_touch == 1 && autotune_tile_size != 0) {
+        amrex::Print() << "Warning: castro.autotune_tile_size is disabled by castro.numa_first_touch" << std::endl;
+        autotune_tile_size = 0;
+    }
+
+    // The autotuners are set up here, once, since tile_size is called
+    // from OpenMP parallel regions.
+
+    int max_level = 0;
+    ppa.query("max_level", max_level);
+    setup_tile_autotuners(max_level);
+
     // Override Amr defaults. Note: this function is called after Amr::Initialize()
     // in Amr::InitAmr(), right before the ParmParse checks, so if the user opts to
     // override our overriding, they can do so.
@@ -619,7 +718,7 @@ Castro::Castro (Amr&            papa,
     // initialize all the new time level data to zero
     for (int k = 0; k < num_state_type; k++) {
       MultiFab& data = get_new_data(k);
-      data.setVal(0.0, data.nGrow());
+      numa_setval(data, 0.0);
     }
 
 #ifdef GRAVITY
@@ -793,11 +892,10 @@ Castro::initMFs()
 #endif
 
 #ifdef RADIATION
+    // The radiation fluxes are allocated by reset_rad_fluxes at the
+    // start of each advance, and only if the flux registers need them.
     if (Radiation::rad_hydro_combined) {
         rad_fluxes.resize(BL_SPACEDIM);
-        for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
-            rad_fluxes[dir].reset(new MultiFab(getEdgeBoxArray(dir), dmap, Radiation::nGroups, 0));
-        }
     }
 #endif
 
@@ -895,6 +993,466 @@ Castro::initMFs()
     }
 }
 
+// Print the memory used by the large buffers on this level. The sizes
+// are computed from the BoxArray and DistributionMapping, so buffers
+// that are only allocated during part of the advance can be reported
+// as well, and no communication is needed.
+
+void
+Castro::memory_report()
+{
+    BL_PROFILE("Castro::memory_report()");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+
+    enum buffer_lifetime {lifetime_level = 0, lifetime_advance, lifetime_hydro, num_lifetimes};
+    const char* lifetime_names[num_lifetimes] = {"level", "advance", "hydro"};
+
+    struct buffer_entry {
+        std::string name;
+        int lifetime;
+        Vector<Long> bytes;
+    };
+
+    Vector<buffer_entry> buffers;
+
+    // Old-time state data that is not allocated because nothing reads it.
+
+    Vector<Long> old_data_saved(nprocs, 0);
+
+    // Radiation data that is not allocated on this level.
+
+    Vector<Long> rad_saved(nprocs, 0);
+
+    auto add_saved = [&] (Vector<Long>& saved, const BoxArray& ba, int ncomp, int ngrow)
+    {
+        for (int i = 0; i < ba.size(); ++i) {
+            saved[dmap[i]] += amrex::grow(ba[i], ngrow).numPts() * ncomp * static_cast<Long>(sizeof(Real));
+        }
+    };
+
+    auto add_buffer = [&] (const std::string& name, int lifetime,
+                           const BoxArray& ba, int ncomp, int ngrow)
+    {
+        auto it = std::find_if(buffers.begin(), buffers.end(),
+                               [&] (const buffer_entry& b) { return b.name == name; });
+
+        if (it == buffers.end()) {
+            buffers.push_back({name, lifetime, Vector<Long>(nprocs, 0)});
+            it = buffers.end() - 1;
+        }
+
+        for (int i = 0; i < ba.size(); ++i) {
+            it->bytes[dmap[i]] += amrex::grow(ba[i], ngrow).numPts() * ncomp * static_cast<Long>(sizeof(Real));
+        }
+    };
+
+    // Data that lives as long as the level. The state data is counted
+    // as it is during an advance, with old data only for the types
+    // that need it.
+
+    for (int k = 0; k < num_state_type; ++k) {
+        if (!state[k].hasNewData()) {
+            continue;
+        }
+
+        const MultiFab& S = get_new_data(k);
+        const std::string name = "state (" + desc_lst[k].name(0) + ")";
+
+        add_buffer(name, lifetime_level, S.boxArray(), S.nComp(), S.nGrow());
+        if (old_data_needed(k)) {
+            add_buffer(name, lifetime_level, S.boxArray(), S.nComp(), S.nGrow());
+        }
+        else {
+            add_saved(old_data_saved, S.boxArray(), S.nComp(), S.nGrow());
+        }
+    }
+
+    for (int dir = 0; dir < 3; ++dir) {
+        add_buffer("fluxes", lifetime_level, fluxes[dir]->boxArray(), fluxes[dir]->nComp(), 0);
+        add_buffer("mass_fluxes", lifetime_level, mass_fluxes[dir]->boxArray(), 1, 0);
+    }
+
+#if (BL_SPACEDIM <= 2)
+    if (!Geom().IsCartesian()) {
+        add_buffer("P_radial", lifetime_level, P_radial.boxArray(), 1, 0);
+    }
+#endif
+
+#ifdef RADIATION
+    if (Radiation::rad_hydro_combined) {
+        for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
+            if (rad_fluxes_needed()) {
+                add_buffer("rad_fluxes", lifetime_level, getEdgeBoxArray(dir), Radiation::nGroups, 0);
+            }
+            else {
+                add_saved(rad_saved, getEdgeBoxArray(dir), Radiation::nGroups, 0);
+            }
+        }
+    }
+#endif
+
+    // Data allocated in initialize_advance and freed in finalize_advance.
+
+    add_buffer("Sborder", lifetime_advance, grids, NUM_STATE, NUM_GROW);
+    add_buffer("sources_for_hydro", lifetime_advance, grids, NSRC, NUM_GROW);
+    add_buffer("source_corrector", lifetime_advance, grids, NSRC, NUM_GROW);
+
+    if (time_integration_method == SimplifiedSpectralDeferredCorrections) {
+        add_buffer("hydro_source", lifetime_advance, grids, NUM_STATE, 0);
+    }
+
+#ifdef DIFFUSION
+    if (diffuse_temp == 1 && time_integration_method != SpectralDeferredCorrections) {
+        add_buffer("old_temp_diff_term", lifetime_advance, grids, 1, 0);
+    }
+#endif
+
+#ifdef TRUE_SDC
+    add_buffer("q", lifetime_advance, grids, NQ, NUM_GROW);
+    add_buffer("qaux", lifetime_advance, grids, NQAUX, NUM_GROW);
+
+    if (sdc_order == 4) {
+        add_buffer("q_bar", lifetime_advance, grids, NQ, NUM_GROW);
+        add_buffer("qaux_bar", lifetime_advance, grids, NQAUX, NUM_GROW);
+#ifdef DIFFUSION
+        add_buffer("T_cc", lifetime_advance, grids, 1, NUM_GROW);
+#endif
+    }
+
+    if (time_integration_method == SpectralDeferredCorrections) {
+        // k_new[0] and A_new[0] are aliases.
+        for (int n = 1; n < SDC_NODES; ++n) {
+            add_buffer("k_new", lifetime_advance, grids, NUM_STATE, 0);
+            add_buffer("A_new", lifetime_advance, grids, NUM_STATE, 0);
+        }
+        for (int n = 0; n < SDC_NODES; ++n) {
+            add_buffer("A_old", lifetime_advance, grids, NUM_STATE, 0);
+#ifdef REACTIONS
+            add_buffer("R_old", lifetime_advance, grids, NUM_STATE, 0);
+#endif
+        }
+        add_buffer("Sburn", lifetime_advance, grids, NUM_STATE, 2);
+    }
+#endif
+
+    // Data allocated only during the hydrodynamics update.
+
+    if (do_hydro) {
+        if (time_integration_method == CornerTransportUpwind) {
+            add_buffer("hydro_source", lifetime_hydro, grids, NUM_STATE, 0);
+        }
+
+#ifdef RADIATION
+        add_buffer("Erborder", lifetime_hydro, grids, Radiation::nGroups, NUM_GROW);
+        if (Radiation::constant_limiter()) {
+            add_saved(rad_saved, grids, Radiation::nGroups, NUM_GROW);
+        }
+        else {
+            add_buffer("lamborder", lifetime_hydro, grids, Radiation::nGroups, NUM_GROW);
+        }
+#endif
+    }
+
+    // The peak on each rank is reached during the hydrodynamics update,
+    // when all three groups are allocated at once.
+
+    Vector<Long> peak(nprocs, 0);
+    Array<Long, num_lifetimes> lifetime_total = {0};
+    Array<Long, num_lifetimes> lifetime_max = {0};
+
+    for (int lt = 0; lt < num_lifetimes; ++lt) {
+        Vector<Long> rank_bytes(nprocs, 0);
+        for (const auto& b : buffers) {
+            if (b.lifetime != lt) {
+                continue;
+            }
+            for (int p = 0; p < nprocs; ++p) {
+                rank_bytes[p] += b.bytes[p];
+            }
+        }
+        for (int p = 0; p < nprocs; ++p) {
+            lifetime_total[lt] += rank_bytes[p];
+            lifetime_max[lt] = amrex::max(lifetime_max[lt], rank_bytes[p]);
+            peak[p] += rank_bytes[p];
+        }
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+
+        const Real MB = 1024.0 * 1024.0;
+
+        std::cout << "\nMemory footprint on level " << level
+                  << " (MB, total over all ranks / largest on any rank):\n";
+
+        for (const auto& b : buffers) {
+            Long total = 0;
+            Long rank_max = 0;
+            for (int p = 0; p < nprocs; ++p) {
+                total += b.bytes[p];
+                rank_max = amrex::max(rank_max, b.bytes[p]);
+            }
+            std::cout << "  " << std::left << std::setw(28) << b.name << std::right
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(12) << total / MB
+                      << std::setw(12) << rank_max / MB
+                      << "   (" << lifetime_names[b.lifetime] << ")\n";
+        }
+
+        for (int lt = 0; lt < num_lifetimes; ++lt) {
+            std::cout << "  " << std::left << std::setw(28) << (std::string("total ") + lifetime_names[lt]) << std::right
+                      << std::setw(12) << lifetime_total[lt] / MB
+                      << std::setw(12) << lifetime_max[lt] / MB << "\n";
+        }
+
+        std::cout << "  " << std::left << std::setw(28) << "peak during advance" << std::right
+                  << std::setw(12) << (lifetime_total[0] + lifetime_total[1] + lifetime_total[2]) / MB
+                  << std::setw(12) << *std::max_element(peak.begin(), peak.end()) / MB << "\n";
+
+        std::cout << "  " << std::left << std::setw(28) << "saved (old data not needed)" << std::right
+                  << std::setw(12) << std::accumulate(old_data_saved.begin(), old_data_saved.end(), Long(0)) / MB
+                  << std::setw(12) << *std::max_element(old_data_saved.begin(), old_data_saved.end()) / MB << "\n";
+
+#ifdef RADIATION
+        std::cout << "  " << std::left << std::setw(28) << "saved (radiation, on demand)" << std::right
+                  << std::setw(12) << std::accumulate(rad_saved.begin(), rad_saved.end(), Long(0)) / MB
+                  << std::setw(12) << *std::max_element(rad_saved.begin(), rad_saved.end()) / MB << "\n";
+#endif
+
+        std::cout << std::defaultfloat << std::setprecision(6) << "\n";
+    }
+}
+
+IntVect
+Castro::default_tile_size(int family)
+{
+    // With NUMA first touch every family uses the hydro tiles, so that
+    // each tile is worked on by the thread that placed its pages.
+
+    return (family == tile_family_hydro || numa_first_touch == 1) ? hydro_tile_size :
+           (TilingIfNotGPU() ? FabArrayBase::mfiter_tile_size : no_tile_size);
+}
+
+void
+Castro::setup_tile_autotuners(int max_level)
+{
+    tile_autotuners.clear();
+
+#ifndef AMREX_USE_GPU
+    if (autotune_tile_size == 0) {
+        return;
+    }
+
+    tile_autotuners.resize(max_level + 1);
+
+    for (int family = 0; family < num_tile_families; ++family) {
+
+        // The hydro wants tiles that keep its many temporaries in cache;
+        // the reactions want enough small tiles to balance the uneven
+        // burning cost over the threads. The default shape goes first,
+        // and is also the one used in the warmup advance.
+
+        Vector<IntVect> shapes;
+
+        if (family == tile_family_hydro) {
+            shapes = {IntVect(AMREX_D_DECL(1024, 8, 8)),
+                      IntVect(AMREX_D_DECL(1024, 16, 16)),
+                      IntVect(AMREX_D_DECL(1024, 32, 32)),
+                      IntVect(AMREX_D_DECL(64, 16, 16)),
+                      IntVect(AMREX_D_DECL(32, 32, 32))};
+        }
+        else {
+            shapes = {IntVect(AMREX_D_DECL(1024, 2, 2)),
+                      IntVect(AMREX_D_DECL(1024, 4, 4)),
+                      IntVect(AMREX_D_DECL(1024, 8, 8)),
+                      IntVect(AMREX_D_DECL(1024, 16, 16)),
+                      IntVect(AMREX_D_DECL(64, 8, 8)),
+                      no_tile_size};
+        }
+
+        const IntVect default_size = default_tile_size(family);
+
+        Vector<IntVect> candidates = {default_size};
+
+        for (const auto& shape : shapes) {
+            if (std::find(candidates.begin(), candidates.end(), shape) == candidates.end()) {
+                candidates.push_back(shape);
+            }
+        }
+
+        for (int lev = 0; lev <= max_level; ++lev) {
+            TileAutotuner& tuner = tile_autotuners[lev][family];
+            tuner.candidates = candidates;
+            tuner.timings.resize(candidates.size(), 0.0);
+            tuner.best = default_size;
+        }
+    }
+#else
+    amrex::ignore_unused(max_level);
+#endif
+}
+
+IntVect
+Castro::tile_size(int family) const
+{
+    // This is called from inside OpenMP parallel regions, so it only
+    // reads the autotuner state set up by setup_tile_autotuners.
+
+    if (level >= static_cast<int>(tile_autotuners.size())) {
+        return default_tile_size(family);
+    }
+
+    const TileAutotuner& tuner = tile_autotuners[level][family];
+
+    if (tuner.done || tuner.current < 0) {
+        return tuner.best;
+    }
+
+    return tuner.candidates[tuner.current];
+}
+
+void
+Castro::record_tile_time(int family, Real run_time)
+{
+    if (level >= static_cast<int>(tile_autotuners.size())) {
+        return;
+    }
+
+    tile_autotuners[level][family].run_time += run_time;
+}
+
+void
+Castro::autotune_tile_sizes()
+{
+#ifndef AMREX_USE_GPU
+    if (level >= static_cast<int>(tile_autotuners.size())) {
+        return;
+    }
+
+    const char* family_names[num_tile_families] = {"hydro", "reactions"};
+
+    for (int family = 0; family < num_tile_families; ++family) {
+
+        TileAutotuner& tuner = tile_autotuners[level][family];
+
+        if (tuner.done || tuner.candidates.empty()) {
+            continue;
+        }
+
+        // Every rank has to make the same choice, so use the time of the
+        // slowest rank. Normalize by the number of zones in case the
+        // level was regridded while tuning.
+
+        Real run_time = tuner.run_time / grids.d_numPts();
+        tuner.run_time = 0.0;
+
+        ParallelDescriptor::ReduceRealMax(run_time);
+
+        // Skip advances where these kernels did not run at all.
+
+        if (run_time <= 0.0) {
+            continue;
+        }
+
+        // The first advance pays for allocations and page faults; don't
+        // charge that to any candidate.
+
+        if (tuner.current < 0) {
+            tuner.current = 0;
+            continue;
+        }
+
+        tuner.timings[tuner.current] += run_time;
+
+        if (++tuner.advances >= autotune_tile_advances) {
+            ++tuner.current;
+            tuner.advances = 0;
+        }
+
+        if (tuner.current == static_cast<int>(tuner.candidates.size())) {
+
+            const auto ibest = std::min_element(tuner.timings.begin(), tuner.timings.end()) - tuner.timings.begin();
+
+            tuner.best = tuner.candidates[ibest];
+            tuner.done = true;
+
+            if (verbose > 0) {
+                amrex::Print() << "... tile size autotuning on level " << level << " chose "
+                               << tuner.best << " for the " << family_names[family] << std::endl;
+            }
+        }
+    }
+#endif
+}
+
+Arena*
+Castro::advance_arena()
+{
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+    if (numa_first_touch == 1) {
+        static FreshPageArena arena;
+        return &arena;
+    }
+#endif
+
+    // The default arena.
+    return nullptr;
+}
+
+void
+Castro::numa_setval(MultiFab& mf, Real val) const
+{
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+    if (numa_first_touch == 1) {
+
+        // OpenMP MFIter loops hand each thread the same contiguous range
+        // of tiles every time, as long as the layout and tile size are
+        // the same, so this matches the later hydro, source and
+        // reaction loops.
+
+#pragma omp parallel
+        for (MFIter mfi(mf, tile_size(tile_family_hydro)); mfi.isValid(); ++mfi) {
+            const Box& gbx = mfi.growntilebox();
+            mf[mfi].setVal<RunOn::Host>(val, gbx, 0, mf.nComp());
+        }
+
+        return;
+    }
+#endif
+
+    mf.setVal(val, mf.nGrow());
+}
+
+void
+Castro::write_tile_size_info(std::ostream& os)
+{
+    if (autotune_tile_size == 0) {
+        return;
+    }
+
+    const char* family_names[num_tile_families] = {"hydro", "reactions"};
+
+    for (int lev = 0; lev < static_cast<int>(tile_autotuners.size()); ++lev) {
+        for (int family = 0; family < num_tile_families; ++family) {
+
+            const TileAutotuner& tuner = tile_autotuners[lev][family];
+
+            if (tuner.candidates.empty()) {
+                continue;
+            }
+
+            os << "level " << lev << " " << std::left << std::setw(10) << family_names[family] << std::right
+               << " tile size: " << tuner.best;
+
+            if (!tuner.done) {
+                os << " (autotuning not finished)";
+            }
+
+            os << "\n";
+        }
+    }
+}
+
 void
 Castro::setTimeLevel (Real time,
                       Real dt_old,
@@ -1474,9 +2032,12 @@ Castro::init (AmrLevel &old)
     for (int s = 0; s < num_state_type; ++s) {
         MultiFab& state_MF = get_new_data(s);
         FillPatch(old, state_MF, state_MF.nGrow(), cur_time, s, 0, state_MF.nComp());
-        if (oldlev->state[s].hasOldData()) {
+        if (oldlev->state[s].hasOldData() && old_data_needed(s)) {
             if (!state[s].hasOldData()) {
                 state[s].allocOldData();
+                if (numa_first_touch == 1) {
+                    numa_setval(state[s].oldData(), 0.0);
+                }
             }
             MultiFab& old_state_MF = get_old_data(s);
             FillPatch(old, old_state_MF, old_state_MF.nGrow(), prev_time, s, 0, old_state_MF.nComp());
@@ -1502,6 +2063,8 @@ Castro::init (AmrLevel &old)
     lastDtFromRetry = oldlev->lastDtFromRetry;
     in_retry = oldlev->in_retry;
 
+    retry_history = oldlev->retry_history;
+
 }
 
 //
@@ -1532,7 +2095,16 @@ Castro::init ()
 
     for (int s = 0; s < num_state_type; ++s) {
         MultiFab& state_MF = get_new_data(s);
-        FillCoarsePatch(state_MF, 0, time, s, 0, state_MF.nComp(), state_MF.nGrow());
+
+        // State types without old data on the coarse level are rebuilt
+        // before they are next read, so their current data will do.
+
+        Real fill_time = time;
+        if (!getLevel(level-1).state[s].hasOldData()) {
+            fill_time = cur_time;
+        }
+
+        FillCoarsePatch(state_MF, 0, fill_time, s, 0, state_MF.nComp(), state_MF.nGrow());
     }
 }
 
@@ -1798,6 +2370,26 @@ Castro::computeNewDt (int                    finest_level,
         }
     }
 
+    //
+    // If we are using predictive retries, do not let the
+    // timestep on a level grow back to a value that has
+    // recently failed there; this avoids repeating the
+    // cycle of growing dt until an advance is rejected.
+    //
+    if (use_retry && use_predictive_retry) {
+        for (int i = 0; i <= finest_level; ++i) {
+            Real dt_pred = getLevel(i).predictive_retry_dt();
+            if (dt_pred < dt_min[i]) {
+                if (verbose && ParallelDescriptor::IOProcessor()) {
+                    std::cout << " ... limiting dt at level " << i << " to: "
+                              << dt_pred << " = predictive retry timestep\n";
+                }
+                dt_min[i] = dt_pred;
+                num_predictive_dt_limits += 1;
+            }
+        }
+    }
+
     //
     // Find the minimum over all levels
     //
@@ -1974,7 +2566,7 @@ Castro::post_timestep (int iteration_local)
     int finest_level = parent->finestLevel();
 
 #ifdef RADIATION
-    if (do_radiation && (level < finest_level)) {
+    if (do_radiation && (level < finest_level) && !radiation->composite_active()) {
         // computeTemp is not needed before or after this call because
         // setup for deferred sync does not touch state, only flux registers.
         radiation->deferred_sync_setup(level);
@@ -1999,6 +2591,19 @@ Castro::post_timestep (int iteration_local)
     if (level < finest_level)
         avgDown();
 
+#ifdef RADIATION
+    // With the composite radiation solve, all the levels take their
+    // implicit update together now that the hydro is synchronized.
+
+    if (do_radiation && level == 0 && radiation->composite_active()) {
+        radiation->MGFLD_composite_update(level);
+
+        for (int lev = finest_level - 1; lev >= level; --lev) {
+            getLevel(lev).avgDown();
+        }
+    }
+#endif
+
 
 #ifdef MHD
     MultiFab& Bx_new = get_new_data(Mag_Type_x);
@@ -2189,6 +2794,10 @@ Castro::post_restart ()
     problem_post_restart();
 #endif
 
+    if (print_memory_report) {
+        memory_report();
+    }
+
 }
 
 void
@@ -2212,6 +2821,10 @@ Castro::post_regrid (int lbase,
 
     fine_mask.clear();
 
+    if (measure_level_idle_time) {
+        num_regions = num_disconnected_regions();
+    }
+
 #ifdef AMREX_PARTICLES
     if (TracerPC && level == lbase) {
         TracerPC->Redistribute(lbase);
@@ -2315,6 +2928,10 @@ Castro::post_regrid (int lbase,
                     S_new, state[State_Type].curTime(), S_new.nGrow());
 
     }
+
+    if (print_memory_report) {
+        memory_report();
+    }
 }
 
 void
@@ -2456,6 +3073,12 @@ Castro::post_init (Real /*stop_time*/)
        write_center();
     }
 #endif
+
+    if (print_memory_report) {
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            getLevel(lev).memory_report();
+        }
+    }
 }
 
 void
@@ -2608,9 +3231,12 @@ Castro::FluxRegCrseInit() {
 #endif
 
 #ifdef RADIATION
+    // The radiation fluxes are not kept without refluxing.
     if (Radiation::rad_hydro_combined) {
       for (int i = 0; i < BL_SPACEDIM; ++i) {
-        fine_level.rad_flux_reg.CrseInit(*rad_fluxes[i], i, 0, 0, Radiation::nGroups, flux_crse_scale);
+        if (rad_fluxes[i]) {
+          fine_level.rad_flux_reg.CrseInit(*rad_fluxes[i], i, 0, 0, Radiation::nGroups, flux_crse_scale);
+        }
       }
     }
 #endif
@@ -2638,15 +3264,61 @@ Castro::FluxRegFineAdd() {
 #endif
 
 #ifdef RADIATION
+    // The radiation fluxes are not kept without refluxing.
     if (Radiation::rad_hydro_combined) {
       for (int i = 0; i < BL_SPACEDIM; ++i) {
-        getLevel(level).rad_flux_reg.FineAdd(*rad_fluxes[i], i, 0, 0, Radiation::nGroups, flux_fine_scale);
+        if (rad_fluxes[i]) {
+          getLevel(level).rad_flux_reg.FineAdd(*rad_fluxes[i], i, 0, 0, Radiation::nGroups, flux_fine_scale);
+        }
       }
     }
 #endif
 
 }
 
+#ifdef RADIATION
+bool
+Castro::rad_fluxes_needed() const
+{
+    if (!Radiation::rad_hydro_combined || !do_reflux) {
+        return false;
+    }
+
+    // A fine level adds them to its own register.  A coarse level
+    // initializes the register of the next finer level, which a post
+    // step regrid may create after this level has advanced.
+
+    if (level > 0 || level < parent->finestLevel()) {
+        return true;
+    }
+
+    return use_post_step_regrid && level < parent->maxLevel();
+}
+
+void
+Castro::reset_rad_fluxes()
+{
+    if (!Radiation::rad_hydro_combined) {
+        return;
+    }
+
+    for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
+        if (rad_fluxes_needed()) {
+            if (rad_fluxes[dir] == nullptr) {
+                rad_fluxes[dir].reset(new MultiFab(getEdgeBoxArray(dir), dmap, Radiation::nGroups, 0));
+            }
+            rad_fluxes[dir]->setVal(0.0);
+        }
+        else {
+            rad_fluxes[dir].reset();
+        }
+
+        // Any level with a finer one fills that level's register.
+        BL_ASSERT(!do_reflux || level == parent->finestLevel() || rad_fluxes[dir] != nullptr);
+    }
+}
+#endif
+
 
 void
 Castro::reflux(int crse_level, int fine_level)
@@ -3025,16 +3697,18 @@ Castro::normalize_species (MultiFab& S_new, int ng)
         {
             Real rhoX_sum = 0.0_rt;
 
-            for (int n = 0; n < NumSpec; ++n) {
+            unroll_for<NumSpec>([&] (int n)
+            {
                 u(i,j,k,UFS+n) = amrex::max(lsmall_x * u(i,j,k,URHO), amrex::min(u(i,j,k,URHO), u(i,j,k,UFS+n)));
                 rhoX_sum += u(i,j,k,UFS+n);
-            }
+            });
 
             Real fac = u(i,j,k,URHO) / rhoX_sum;
 
-            for (int n = 0; n < NumSpec; ++n) {
+            unroll_for<NumSpec>([&] (int n)
+            {
                 u(i,j,k,UFS+n) *= fac;
-            }
+            });
         });
     }
 }
@@ -3208,8 +3882,14 @@ Castro::allocOldData ()
 {
     MultiFab::RegionTag amrlevel_tag("AmrLevel_Level_" + std::to_string(level));
     MultiFab::RegionTag statedata_tag("StateData_Level_" + std::to_string(level));
-    for (int k = 0; k < num_state_type; k++)
-        state[k].allocOldData();
+    for (int k = 0; k < num_state_type; k++) {
+        if (old_data_needed(k)) {
+            state[k].allocOldData();
+            if (numa_first_touch == 1) {
+                numa_setval(state[k].oldData(), 0.0);
+            }
+        }
+    }
 }
 
 void
@@ -4187,6 +4867,54 @@ Castro::create_source_corrector()
 
 
 
+bool
+Castro::old_data_needed(int k) const
+{
+    // The retry and subcycling machinery only ever restores the
+    // old data of the types that have it, so a type can go without
+    // old data whenever its new data is rebuilt from scratch before
+    // it is read during the advance.
+
+#ifdef REACTIONS
+    // Only the Strang-split CTU burn writes (and the coarse-fine fill
+    // of the first half burn reads) the old reaction data.
+
+    if (k == Reactions_Type && time_integration_method != CornerTransportUpwind) {
+        return false;
+    }
+#endif
+
+#ifdef SIMPLIFIED_SDC
+#ifdef REACTIONS
+    if (k == Simplified_SDC_React_Type && time_integration_method == SimplifiedSpectralDeferredCorrections) {
+        return false;
+    }
+#endif
+#endif
+
+#ifdef TRUE_SDC
+#ifdef REACTIONS
+    if (k == SDC_Source_Type && time_integration_method == SpectralDeferredCorrections && sdc_order == 4) {
+        return false;
+    }
+#endif
+#endif
+
+#ifdef GRAVITY
+    if ((k == Gravity_Type || k == PhiGrav_Type) && !do_grav) {
+        return false;
+    }
+#endif
+
+#ifdef ROTATION
+    if (k == PhiRot_Type && !do_rotation) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 void
 Castro::swap_state_time_levels(const Real dt)
 {
@@ -4198,32 +4926,22 @@ Castro::swap_state_time_levels(const Real dt)
 
     for (int k = 0; k < num_state_type; k++) {
 
-        // The following is a hack to make sure that we only
-        // ever have new data for certain state types that only
-        // ever need new time data; by doing a swap now, we'll
-        // guarantee that allocOldData() does nothing. We do
-        // this because we never need the old data, so we
-        // don't want to allocate memory for it.
+        // For state types that only ever need new time data, drop
+        // any old data (e.g. read from a checkpoint) and swap twice:
+        // the first swap moves the new data into the old slot, so
+        // allocOldData() does nothing, and the second moves it back.
 
-#ifdef SIMPLIFIED_SDC
-#ifdef REACTIONS
-        if (time_integration_method == SimplifiedSpectralDeferredCorrections) {
-            if (k == Simplified_SDC_React_Type) {
-                state[k].swapTimeLevels(0.0);
-            }
+        if (!old_data_needed(k)) {
+            state[k].removeOldData();
+            state[k].swapTimeLevels(0.0);
         }
-#endif
-#endif
 
-#ifdef TRUE_SDC
-#ifdef REACTIONS
-        if (time_integration_method == SpectralDeferredCorrections &&
-            sdc_order == 4 && k == SDC_Source_Type) {
-          state[k].swapTimeLevels(0.0);
+        if (!state[k].hasOldData()) {
+            state[k].allocOldData();
+            if (numa_first_touch == 1) {
+                numa_setval(state[k].oldData(), 0.0);
+            }
         }
-#endif
-#endif
-        state[k].allocOldData();
 
         state[k].swapTimeLevels(dt);
 
@@ -4503,6 +5221,7 @@ void
 Castro::expand_state(MultiFab& S, Real time, int ng)
 {
   BL_PROFILE("Castro::expand_state()");
+  CASTRO_PERF_REGION(perf_fillpatch);
 
   BL_ASSERT(S.nGrow() >= ng);
 
@@ -4510,6 +5229,43 @@ Castro::expand_state(MultiFab& S, Real time, int ng)
 }
 
 
+bool
+Castro::overlap_hydro_halo() const
+{
+#ifdef RADIATION
+  // The radiation hydro fills its own ghost zones inside the update.
+  return false;
+#else
+  return hydro_overlap_halo == 1 && level == 0;
+#endif
+}
+
+
+void
+Castro::start_halo_fill(MultiFab& S, int ng)
+{
+  BL_PROFILE("Castro::start_halo_fill()");
+
+  BL_ASSERT(S.nGrow() >= ng);
+  BL_ASSERT(S.boxArray() == grids);
+
+  S.FillBoundary_nowait(0, S.nComp(), IntVect(ng), geom.periodicity());
+}
+
+
+void
+Castro::finish_halo_fill(MultiFab& S, Real time, int ng, int state_idx, int scomp)
+{
+  BL_PROFILE("Castro::finish_halo_fill()");
+  CASTRO_PERF_REGION(perf_fillpatch);
+
+  S.FillBoundary_finish();
+
+  StateDataPhysBCFunct physbcf(state[state_idx], scomp, geom);
+  physbcf(S, 0, S.nComp(), IntVect(ng), time, 0);
+}
+
+
 void
 Castro::check_for_nan(MultiFab& state_in, int check_ghost)
 {
@@ -4546,6 +5302,7 @@ Castro::clean_state(
                     MultiFab& state_in, Real time, int ng) {
 
     BL_PROFILE("Castro::clean_state()");
+    CASTRO_PERF_REGION(perf_clean_state);
 
     // Enforce a minimum density.
 
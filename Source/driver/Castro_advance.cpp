@@ -12,6 +12,7 @@
 
 #include <cmath>
 #include <climits>
+#include <iomanip>
 
 using std::string;
 using namespace amrex;
@@ -117,10 +118,138 @@ Castro::advance (Real time,
 
     finalize_advance();
 
+    if (measure_level_idle_time) {
+        measure_level_idle();
+    }
+
     return dt_new;
 }
 
 
+
+void
+Castro::measure_level_idle()
+{
+    BL_PROFILE("Castro::measure_level_idle()");
+
+    const int nlevs = parent->maxLevel() + 1;
+
+    if (level_work_time.size() < nlevs) {
+        level_work_time.resize(nlevs, 0.0);
+        level_num_regions.resize(nlevs, 0);
+    }
+
+    // No synchronization is added here: the imbalance across the ranks
+    // is only estimated at the end of the run from the accumulated
+    // times. The work time includes any waiting inside the collectives
+    // of the advance itself, so that estimate is a lower bound on the
+    // time lost to load imbalance at this level.
+
+    level_work_time[level] += ParallelDescriptor::second() - wall_time_start;
+
+    // The region count only changes with the grids, so it is kept from
+    // the last regrid; levels that have not been regridded since
+    // initialization or restart count them here once.
+
+    if (num_regions < 0) {
+        num_regions = num_disconnected_regions();
+    }
+
+    level_num_regions[level] = num_regions;
+}
+
+
+
+int
+Castro::num_disconnected_regions() const
+{
+    BL_PROFILE("Castro::num_disconnected_regions()");
+
+    // Union-find over the boxes of this level: two boxes are in the same
+    // region if one overlaps the other when grown by the number of ghost
+    // zones used in the advance, since they then exchange data in every
+    // ghost cell fill. Periodic images are not considered.
+
+    const int nboxes = grids.size();
+
+    Vector<int> group(nboxes);
+    for (int i = 0; i < nboxes; ++i) {
+        group[i] = i;
+    }
+
+    auto find_root = [&] (int i) -> int
+    {
+        while (group[i] != i) {
+            group[i] = group[group[i]];
+            i = group[i];
+        }
+        return i;
+    };
+
+    for (int i = 0; i < nboxes; ++i) {
+        const auto isects = grids.intersections(amrex::grow(grids[i], NUM_GROW));
+        for (const auto& is : isects) {
+            int a = find_root(i);
+            int b = find_root(is.first);
+            if (a != b) {
+                group[a] = b;
+            }
+        }
+    }
+
+    int num_regions = 0;
+    for (int i = 0; i < nboxes; ++i) {
+        if (find_root(i) == i) {
+            ++num_regions;
+        }
+    }
+
+    return num_regions;
+}
+
+
+
+void
+Castro::print_level_idle_statistics()
+{
+    if (!measure_level_idle_time) return;
+
+    const int nlevs = level_work_time.size();
+
+    if (nlevs == 0) return;
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    Vector<Real> work_sum(level_work_time);
+    Vector<Real> work_max(level_work_time);
+
+    ParallelDescriptor::ReduceRealSum(work_sum.dataPtr(), nlevs, IOProc);
+    ParallelDescriptor::ReduceRealMax(work_max.dataPtr(), nlevs, IOProc);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "\n";
+        std::cout << "  Level advance work times (averaged over ranks) and estimated idle times:\n";
+        for (int lev = 0; lev < nlevs; ++lev) {
+            // a rank that did less work than the slowest one waited
+            // for it at some point during the run
+            Real work_avg = work_sum[lev] / nprocs;
+            Real idle_avg = work_max[lev] - work_avg;
+            Real idle_frac = (work_max[lev] > 0.0) ? idle_avg / work_max[lev] : 0.0;
+
+            std::cout << "    level " << lev
+                      << ": work = " << work_avg
+                      << " (max " << work_max[lev] << ")"
+                      << ", idle = " << idle_avg
+                      << " (" << std::fixed << std::setprecision(1) << 100.0 * idle_frac << "%)"
+                      << std::defaultfloat << std::setprecision(6)
+                      << ", disconnected regions = " << level_num_regions[lev] << "\n";
+        }
+        std::cout << "\n";
+    }
+}
+
+
 void
 Castro::initialize_do_advance(Real time)
 {
@@ -180,14 +309,20 @@ Castro::initialize_do_advance(Real time)
       // state note: a clean_state has already been done on the old
       // state in initialize_advance so we don't need to do another
       // one here
-      Sborder.define(grids, dmap, NUM_STATE, NUM_GROW, MFInfo().SetTag("Sborder"));
+      Sborder.define(grids, dmap, NUM_STATE, NUM_GROW, MFInfo().SetTag("Sborder").SetArena(advance_arena()));
+      if (numa_first_touch == 1) {
+          numa_setval(Sborder, 0.0);
+      }
       const Real prev_time = state[State_Type].prevTime();
       expand_state(Sborder, prev_time, NUM_GROW);
 
     } else if (time_integration_method == SpectralDeferredCorrections) {
 
       // we'll handle the filling inside of do_advance_sdc 
-      Sborder.define(grids, dmap, NUM_STATE, NUM_GROW, MFInfo().SetTag("Sborder"));
+      Sborder.define(grids, dmap, NUM_STATE, NUM_GROW, MFInfo().SetTag("Sborder").SetArena(advance_arena()));
+      if (numa_first_touch == 1) {
+          numa_setval(Sborder, 0.0);
+      }
 
     } else {
       amrex::Abort("invalid time_integration_method");
@@ -246,7 +381,7 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
     lastDtFromRetry = 1.e200;
     in_retry = false;
 
-    if (use_post_step_regrid && level > 0) {
+    if (use_post_step_regrid && level > 0 && do_reflux) {
 
         if (getLevel(level-1).post_step_regrid && amr_iteration == 1) {
 
@@ -269,9 +404,6 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
     if (do_radiation) {
         radiation->pre_timestep(level);
     }
-
-    Erborder.define(grids, dmap, Radiation::nGroups, NUM_GROW);
-    lamborder.define(grids, dmap, Radiation::nGroups, NUM_GROW);
 #endif
 
 #ifdef GRAVITY
@@ -287,13 +419,13 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
     // This array holds the sum of all source terms that affect the
     // hydrodynamics.
 
-    sources_for_hydro.define(grids, dmap, NSRC, NUM_GROW);
-    sources_for_hydro.setVal(0.0, NUM_GROW);
+    sources_for_hydro.define(grids, dmap, NSRC, NUM_GROW, MFInfo().SetArena(advance_arena()));
+    numa_setval(sources_for_hydro, 0.0);
 
     // This array holds the source term corrector.
 
-    source_corrector.define(grids, dmap, NSRC, NUM_GROW);
-    source_corrector.setVal(0.0, NUM_GROW);
+    source_corrector.define(grids, dmap, NSRC, NUM_GROW, MFInfo().SetArena(advance_arena()));
+    numa_setval(source_corrector, 0.0);
 
     // Swap the new data from the last timestep into the old state data.
 
@@ -328,11 +460,15 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
         prev_state[k].reset(new StateData());
     }
 
-    // This array holds the hydrodynamics update.
-    if (time_integration_method == CornerTransportUpwind || time_integration_method == SimplifiedSpectralDeferredCorrections) {
-      hydro_source.define(grids,dmap,NUM_STATE,0);
-    }
+    // This array holds the hydrodynamics update. The simplified SDC
+    // reaction update needs it after the hydro, so it lives for the
+    // whole advance; with CTU it is only allocated during the hydro
+    // update in do_advance_ctu.
 
+    if (time_integration_method == SimplifiedSpectralDeferredCorrections) {
+      hydro_source.define(grids, dmap, NUM_STATE, 0, MFInfo().SetTag("hydro_source").SetArena(advance_arena()));
+      numa_setval(hydro_source, 0.0);
+    }
 
     // Allocate space for the primitive variables.
 
@@ -408,11 +544,7 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
 #endif
 
 #ifdef RADIATION
-    if (Radiation::rad_hydro_combined) {
-        for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
-            rad_fluxes[dir]->setVal(0.0);
-        }
-    }
+    reset_rad_fluxes();
 #endif
 
 }
@@ -430,9 +562,12 @@ Castro::finalize_advance()
     }
 
 
-    if (time_integration_method == CornerTransportUpwind || time_integration_method == SimplifiedSpectralDeferredCorrections) {
-      hydro_source.clear();
-    }
+    hydro_source.clear();
+
+#ifdef DIFFUSION
+    old_temp_diff_term.clear();
+    old_temp_diff_time = -1.0;
+#endif
 
 #ifdef TRUE_SDC
     q.clear();
@@ -447,11 +582,6 @@ Castro::finalize_advance()
     }
 #endif
 
-#ifdef RADIATION
-    Erborder.clear();
-    lamborder.clear();
-#endif
-
     source_corrector.clear();
     sources_for_hydro.clear();
 
@@ -466,11 +596,13 @@ Castro::finalize_advance()
       A_old.clear();
 #ifdef REACTIONS
       R_old.clear();
-      Sburn.clear();
 #endif
+      Sburn.clear();
     }
 #endif
 
+    autotune_tile_sizes();
+
     // Record how many zones we have advanced.
 
     num_zones_advanced += static_cast<Real>(grids.numPts()) / getLevel(0).grids.numPts();
@@ -2,6 +2,8 @@
 #include <Castro.H>
 #include <Castro_F.H>
 
+#include <algorithm>
+
 #ifdef RADIATION
 #include <Radiation.H>
 #endif
@@ -29,6 +31,7 @@ Castro::do_advance_ctu(Real time,
     advance_status status;
     status.success = true;
     status.reason = "";
+    status.cause = retry_none;
 
     const Real prev_time = state[State_Type].prevTime();
     const Real  cur_time = state[State_Type].curTime();
@@ -85,11 +88,12 @@ Castro::do_advance_ctu(Real time,
 #ifdef REACTIONS
     bool burn_success = true;
 
-    MultiFab& R_old = get_old_data(Reactions_Type);
-    MultiFab& R_new = get_new_data(Reactions_Type);
-
     if (time_integration_method != SimplifiedSpectralDeferredCorrections) {
 
+        // Old-time reaction data is only allocated for this method.
+
+        MultiFab& R_old = get_old_data(Reactions_Type);
+
         // The result of the reactions is added directly to Sborder.
         burn_success = react_state(Sborder, R_old, prev_time, 0.5 * dt);
         clean_state(
@@ -112,6 +116,9 @@ Castro::do_advance_ctu(Real time,
         // Do this for the reactions as well, in case we cut the timestep
         // short due to it being rejected.
 
+        MultiFab& R_old = get_old_data(Reactions_Type);
+        MultiFab& R_new = get_new_data(Reactions_Type);
+
         MultiFab::Copy(R_new, R_old, 0, 0, R_new.nComp(), R_new.nGrow());
 
         // Skip the rest of the advance if the burn was unsuccessful.
@@ -119,6 +126,7 @@ Castro::do_advance_ctu(Real time,
         if (!burn_success) {
             status.success = false;
             status.reason = "first Strang burn unsuccessful";
+            status.cause = retry_burn_failure;
             return status;
         }
 
@@ -152,8 +160,16 @@ Castro::do_advance_ctu(Real time,
       // in case we have already started with some source
       // terms (e.g. the source term predictor, or the SDC source).
 
+     // When overlapping communication with the hydro, only the valid
+     // data is added here; the ghost zones follow during the update.
+
      if (do_hydro) {
-         AmrLevel::FillPatchAdd(*this, sources_for_hydro, NUM_GROW, time, Source_Type, 0, NSRC);
+         if (overlap_hydro_halo()) {
+             MultiFab::Add(sources_for_hydro, old_source, 0, 0, NSRC, 0);
+         }
+         else {
+             AmrLevel::FillPatchAdd(*this, sources_for_hydro, NUM_GROW, time, Source_Type, 0, NSRC);
+         }
      }
 
     } else {
@@ -175,20 +191,54 @@ Castro::do_advance_ctu(Real time,
       if (cfl_violation) {
           status.success = false;
           status.reason = "CFL violation";
+          status.cause = retry_cfl_violation;
           return status;
       }
 
-      construct_ctu_hydro_source(time, dt);
+      // With CTU the hydrodynamics update is only needed while we
+      // apply it, so it does not stay allocated for the rest of the
+      // advance. Simplified SDC keeps it for the reaction update.
+
+      if (time_integration_method == CornerTransportUpwind) {
+          hydro_source.define(grids, dmap, NUM_STATE, 0, MFInfo().SetTag("hydro_source").SetArena(advance_arena()));
+      }
+
+      if (overlap_hydro_halo() && apply_sources()) {
+
+          // Exchange the ghost zones of the old sources while we update
+          // the parts of the tiles that do not need them. Zeroing the
+          // valid data afterward lets us add only the ghost zones, since
+          // the valid data was already added.
+
+          MultiFab source_halo(grids, dmap, NSRC, NUM_GROW);
+          MultiFab::Copy(source_halo, old_source, 0, 0, NSRC, 0);
+          start_halo_fill(source_halo, NUM_GROW);
+
+          construct_ctu_hydro_source(time, dt, &source_halo);
+
+      }
+      else {
+          construct_ctu_hydro_source(time, dt);
+      }
+
       apply_source_to_state(S_new, hydro_source, dt, 0);
 
       if (print_update_diagnostics) {
           evaluate_and_print_source_change(hydro_source, dt, "hydro source");
       }
 #else
+      if (time_integration_method == CornerTransportUpwind) {
+          hydro_source.define(grids, dmap, NUM_STATE, 0, MFInfo().SetTag("hydro_source").SetArena(advance_arena()));
+      }
+
       construct_ctu_mhd_source(time, dt);
       apply_source_to_state(S_new, hydro_source, dt, 0);
 #endif
 
+      if (time_integration_method == CornerTransportUpwind) {
+          hydro_source.clear();
+      }
+
       // Check for small/negative densities.
       // If we detect one, return immediately.
 
@@ -219,6 +269,7 @@ Castro::do_advance_ctu(Real time,
 
           if (starting_density >= retry_small_density_cutoff) {
               status.success = false;
+              status.cause = retry_small_density;
 
               if (minimum_density < 0.0_rt) {
                   status.reason = "negative density";
@@ -333,6 +384,7 @@ Castro::do_advance_ctu(Real time,
             if (!burn_success) {
                 status.success = false;
                 status.reason = "burn unsuccessful";
+                status.cause = retry_burn_failure;
                 return status;
             }
 
@@ -359,6 +411,8 @@ Castro::do_advance_ctu(Real time,
 
     if (time_integration_method != SimplifiedSpectralDeferredCorrections) {
 
+        MultiFab& R_new = get_new_data(Reactions_Type);
+
         burn_success = react_state(S_new, R_new, cur_time - 0.5 * dt, 0.5 * dt);
         clean_state(
 #ifdef MHD
@@ -371,6 +425,7 @@ Castro::do_advance_ctu(Real time,
         if (!burn_success) {
             status.success = false;
             status.reason = "second Strang burn unsuccessful";
+            status.cause = retry_burn_failure;
             return status;
         }
 
@@ -394,6 +449,7 @@ Castro::do_advance_ctu(Real time,
     if (castro::change_max * new_dt < dt) {
         status.success = false;
         status.reason = "timestep validity check failed";
+        status.cause = retry_timestep_validity;
         return status;
     }
 
@@ -474,11 +530,7 @@ Castro::retry_advance_ctu(Real dt, advance_status status)
 #endif
 
 #ifdef RADIATION
-        if (Radiation::rad_hydro_combined) {
-          for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
-            rad_fluxes[dir]->setVal(0.0);
-          }
-        }
+        reset_rad_fluxes();
 #endif
 
         // For simplified SDC, we'll have garbage data if we
@@ -506,6 +558,81 @@ Castro::retry_advance_ctu(Real dt, advance_status status)
 
 
 
+void
+Castro::record_retry(Real dt, const advance_status& status)
+{
+    BL_PROFILE("Castro::record_retry()");
+
+    if (status.cause > retry_none && status.cause < num_retry_causes) {
+        num_retries[status.cause] += 1;
+    }
+
+    retry_record record;
+    record.step = parent->levelSteps(0);
+    record.dt = dt;
+    record.cause = status.cause;
+
+    retry_history.push_back(record);
+}
+
+
+
+Real
+Castro::predictive_retry_dt()
+{
+    BL_PROFILE("Castro::predictive_retry_dt()");
+
+    // Forget about failures that are older than the history window.
+
+    const int current_step = parent->levelSteps(0);
+
+    retry_history.erase(std::remove_if(retry_history.begin(), retry_history.end(),
+                                       [=] (const retry_record& r) { return current_step - r.step > retry_history_window; }),
+                        retry_history.end());
+
+    Real dt_pred = 1.e200;
+
+    for (const auto& r : retry_history) {
+        dt_pred = std::min(dt_pred, retry_predictive_factor * r.dt);
+    }
+
+    return dt_pred;
+}
+
+
+
+void
+Castro::print_retry_statistics()
+{
+    if (!use_retry) return;
+
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    Real wall_time = retry_wall_time;
+    ParallelDescriptor::ReduceRealMax(wall_time, IOProc);
+
+    int total_retries = 0;
+    for (int n = 0; n < num_retry_causes; ++n) {
+        total_retries += num_retries[n];
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "\n";
+        std::cout << "  Number of rejected advances: " << total_retries << "\n";
+        std::cout << "    small or negative density: " << num_retries[retry_small_density] << "\n";
+        std::cout << "    burn failure:              " << num_retries[retry_burn_failure] << "\n";
+        std::cout << "    CFL violation:             " << num_retries[retry_cfl_violation] << "\n";
+        std::cout << "    timestep validity check:   " << num_retries[retry_timestep_validity] << "\n";
+        std::cout << "  Wall time spent in rejected advances: " << wall_time << "\n";
+        if (use_predictive_retry) {
+            std::cout << "  Number of timesteps limited by predictive retry: " << num_predictive_dt_limits << "\n";
+        }
+        std::cout << "\n";
+    }
+}
+
+
+
 Real
 Castro::subcycle_advance_ctu(const Real time, const Real dt, int amr_iteration, int amr_ncycle)
 {
@@ -652,8 +779,17 @@ Castro::subcycle_advance_ctu(const Real time, const Real dt, int amr_iteration,
 
             // We do the hydro advance here, and record whether we completed it.
 
+            Real advance_start_time = ParallelDescriptor::second();
+
             status = do_advance_ctu(subcycle_time, dt_subcycle, amr_iteration, amr_ncycle);
 
+            // Keep track of how much time we spent on advances that
+            // will be thrown away by the retry.
+
+            if (!status.success) {
+                retry_wall_time += ParallelDescriptor::second() - advance_start_time;
+            }
+
             if (in_retry) {
                 in_retry = false;
             }
@@ -695,6 +831,13 @@ Castro::subcycle_advance_ctu(const Real time, const Real dt, int amr_iteration,
             // The retry function will handle resetting the state,
             // and updating dt_subcycle.
 
+            // The retry history limits the level timestep, so we
+            // record the level dt rather than the subcycled one.
+
+            if (!status.success) {
+                record_retry(dt, status);
+            }
+
             if (retry_advance_ctu(dt_subcycle, status)) {
                 do_swap = false;
                 lastDtRetryLimited = true;
@@ -76,7 +76,26 @@ Castro::do_advance_sdc (Real time,
     // work for multilevel.
     MultiFab::Copy(S_new, *(k_new[m]), 0, 0, S_new.nComp(), 0);
     clean_state(S_new, cur_time, 0);
-    expand_state(Sborder, cur_time, NUM_GROW);
+
+    // Optionally exchange the ghost zones of Sborder while we construct
+    // the old-time gravity, which does not read Sborder.  The fill is
+    // finished before the other sources are evaluated, since some of
+    // them (e.g. the thermodynamic source) read neighboring zones.
+    // This is not done at fourth order, since the conversion to cell
+    // centers needs the ghost zones, or with diffusion, which fills
+    // its own from Sborder.
+
+    bool sborder_fill_pending = overlap_hydro_halo() && sdc_order == 2;
+#ifdef DIFFUSION
+    sborder_fill_pending = false;
+#endif
+
+    if (sborder_fill_pending) {
+      MultiFab::Copy(Sborder, S_new, 0, 0, NUM_STATE, 0);
+      start_halo_fill(Sborder, NUM_GROW);
+    } else {
+      expand_state(Sborder, cur_time, NUM_GROW);
+    }
 
 
     // the next chunk of code constructs the advective term for the
@@ -134,6 +153,11 @@ Castro::do_advance_sdc (Real time,
           }
 
         } else {
+          if (sborder_fill_pending) {
+            finish_halo_fill(Sborder, cur_time, NUM_GROW, State_Type, 0);
+            sborder_fill_pending = false;
+          }
+
           // there is a ghost cell fill hidden in diffusion, so we need
           // to pass in the time associate with Sborder
           do_old_sources(old_source, Sborder, Sborder, cur_time, dt, apply_sources_to_state);
@@ -160,6 +184,10 @@ Castro::do_advance_sdc (Real time,
       // Now compute the advective term for the current node -- this
       // will be used to advance us to the next node the new time
 
+      if (sborder_fill_pending) {
+        finish_halo_fill(Sborder, cur_time, NUM_GROW, State_Type, 0);
+        sborder_fill_pending = false;
+      }
 
       // Construct the primitive variables.
       if (sdc_order == 4) {
@@ -184,6 +212,11 @@ Castro::do_advance_sdc (Real time,
 
     } // end of the m = 0 sdc_iter > 0 check
 
+    if (sborder_fill_pending) {
+      finish_halo_fill(Sborder, cur_time, NUM_GROW, State_Type, 0);
+      sborder_fill_pending = false;
+    }
+
     // also, if we are the first SDC iteration, we haven't yet stored
     // any old advective terms, so we cannot yet do the quadrature
     // over nodes.  Initialize those now.  Recall, A_new[0] and A_old[0]
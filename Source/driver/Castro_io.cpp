@@ -576,6 +576,7 @@ Castro::writeJobInfo (const std::string& dir, const Real io_time)
 #endif
   jobInfoFile << "\n";
   jobInfoFile << "hydro tile size:         " << hydro_tile_size << "\n";
+  write_tile_size_info(jobInfoFile);
 
   jobInfoFile << "\n";
   jobInfoFile << "CPU time used since start of simulation (CPU-hours): " <<
@@ -23,6 +23,7 @@
 
 #include <Castro.H>
 #include <Castro_io.H>
+#include <perf_counters.H>
 
 using namespace amrex;
 
@@ -115,6 +116,10 @@ main (int   argc,
 
     Amr* amrptr = new Amr;
 
+#ifdef CASTRO_PERF_COUNTERS
+    perf_counters::initialize();
+#endif
+
     amrptr->init(strt_time,stop_time);
 
     // If we set the regrid_on_restart flag and if we are *not* going to take
@@ -212,6 +217,13 @@ main (int   argc,
         std::cout << "\n";
     }
 
+    Castro::print_retry_statistics();
+    Castro::print_level_idle_statistics();
+
+#ifdef CASTRO_PERF_COUNTERS
+    perf_counters::finalize();
+#endif
+
     if (CArena* arena = dynamic_cast<CArena*>(amrex::The_Arena()))
     {
         //
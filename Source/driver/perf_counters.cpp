@@ -0,0 +1,286 @@
+#ifdef CASTRO_PERF_COUNTERS
+
+#include <perf_counters.H>
+#include <castro_params.H>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+namespace perf_counters
+{
+
+namespace
+{
+    enum perf_event_index { ev_cycles = 0,
+                            ev_instructions,
+                            ev_llc_misses,
+                            ev_fp_ops,
+                            num_events
+                          };
+
+    const char* region_names[num_perf_regions] = {"construct_ctu_hydro_source",
+                                                  "react_state",
+                                                  "solve_phi_with_mlmg",
+                                                  "fill_multipole_BCs",
+                                                  "MGFLD_implicit_update",
+                                                  "clean_state",
+                                                  "FillPatch"};
+
+    // assumed size of the memory transfer behind each cache miss
+    constexpr double cache_line_bytes = 64.0;
+
+    // file descriptors for each thread and event; -1 if not counted
+    std::vector<std::array<int, num_events> > fds;
+
+    int nthreads = 0;
+    bool initialized = false;
+
+    struct RegionTotals
+    {
+        long calls = 0;
+        double wall_time = 0.0;
+        std::array<double, num_events> counts{};
+    };
+
+    std::array<RegionTotals, num_perf_regions> totals;
+
+    int open_event (std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // pid = 0, cpu = -1: the calling thread, on whichever CPU it runs
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    // Read (value, time enabled, time running) for every thread and event.
+    void read_all (std::vector<std::uint64_t>& buf)
+    {
+        buf.assign(3 * nthreads * num_events, 0);
+
+        for (int t = 0; t < nthreads; ++t) {
+            for (int e = 0; e < num_events; ++e) {
+                if (fds[t][e] < 0) continue;
+                std::uint64_t* data = &buf[3 * (t * num_events + e)];
+                if (::read(fds[t][e], data, 3 * sizeof(std::uint64_t)) != 3 * sizeof(std::uint64_t)) {
+                    data[0] = data[1] = data[2] = 0;
+                }
+            }
+        }
+    }
+}
+
+void
+initialize ()
+{
+    if (initialized) return;
+
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#else
+    nthreads = 1;
+#endif
+
+    fds.assign(nthreads, {-1, -1, -1, -1});
+
+    // There is no portable floating point event, so it has to be
+    // given as a raw event code for the processor at hand.
+
+    const bool count_fp = !castro::perf_fp_event.empty();
+    std::uint64_t fp_config = 0;
+    if (count_fp) {
+        fp_config = std::stoull(castro::perf_fp_event, nullptr, 0);
+    }
+
+    // A counter only counts the thread that opened it, so each OpenMP
+    // thread opens its own; the thread team is reused by all later
+    // parallel regions.
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+        fds[tid][ev_cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[tid][ev_instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[tid][ev_llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        if (count_fp) {
+            fds[tid][ev_fp_ops] = open_event(PERF_TYPE_RAW, fp_config);
+        }
+    }
+
+    int failed = 0;
+    for (int t = 0; t < nthreads; ++t) {
+        for (int e = 0; e < num_events; ++e) {
+            if (fds[t][e] < 0 && (e != ev_fp_ops || count_fp)) {
+                failed = 1;
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceIntMax(failed);
+
+    if (failed) {
+        amrex::Print() << "Warning: some perf_event counters could not be opened"
+                       << " (see /proc/sys/kernel/perf_event_paranoid); they will be reported as zero" << std::endl;
+    }
+
+    initialized = true;
+}
+
+void
+finalize ()
+{
+    if (!initialized) return;
+
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    // Counts are summed over the ranks and the time is that of the
+    // slowest rank, so the rates are for the whole job.
+
+    Vector<Real> counts(num_perf_regions * num_events);
+    Vector<Real> wall_time(num_perf_regions);
+    Vector<Real> calls(num_perf_regions);
+
+    for (int r = 0; r < num_perf_regions; ++r) {
+        for (int e = 0; e < num_events; ++e) {
+            counts[r * num_events + e] = totals[r].counts[e];
+        }
+        wall_time[r] = totals[r].wall_time;
+        calls[r] = static_cast<Real>(totals[r].calls);
+    }
+
+    ParallelDescriptor::ReduceRealSum(counts.dataPtr(), counts.size(), IOProc);
+    ParallelDescriptor::ReduceRealMax(wall_time.dataPtr(), num_perf_regions, IOProc);
+    ParallelDescriptor::ReduceRealMax(calls.dataPtr(), num_perf_regions, IOProc);
+
+    if (ParallelDescriptor::IOProcessor()) {
+
+        std::cout << "\n";
+        std::cout << "  Hardware counters per region (summed over ranks; DRAM traffic estimated from LLC misses):\n";
+        std::cout << "    " << std::left << std::setw(28) << "region" << std::right
+                  << std::setw(8) << "calls"
+                  << std::setw(12) << "time (s)"
+                  << std::setw(14) << "Gcycles"
+                  << std::setw(8) << "IPC"
+                  << std::setw(14) << "LLC miss/kI"
+                  << std::setw(12) << "DRAM GB/s"
+                  << std::setw(12) << "GFLOP/s"
+                  << std::setw(12) << "FLOP/byte" << "\n";
+
+        for (int r = 0; r < num_perf_regions; ++r) {
+
+            if (calls[r] == 0.0) continue;
+
+            const Real* c = &counts[r * num_events];
+            const Real t = wall_time[r];
+            const Real bytes = c[ev_llc_misses] * cache_line_bytes;
+
+            std::cout << "    " << std::left << std::setw(28) << region_names[r] << std::right
+                      << std::setw(8) << static_cast<long>(calls[r])
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << t
+                      << std::setw(14) << c[ev_cycles] / 1.e9
+                      << std::setw(8) << (c[ev_cycles] > 0.0 ? c[ev_instructions] / c[ev_cycles] : 0.0)
+                      << std::setw(14) << (c[ev_instructions] > 0.0 ? 1000.0 * c[ev_llc_misses] / c[ev_instructions] : 0.0)
+                      << std::setw(12) << (t > 0.0 ? bytes / t / 1.e9 : 0.0);
+
+            if (castro::perf_fp_event.empty()) {
+                std::cout << std::setw(12) << "-" << std::setw(12) << "-";
+            }
+            else {
+                std::cout << std::setw(12) << (t > 0.0 ? c[ev_fp_ops] / t / 1.e9 : 0.0)
+                          << std::setw(12) << (bytes > 0.0 ? c[ev_fp_ops] / bytes : 0.0);
+            }
+
+            std::cout << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+
+        std::cout << "\n";
+    }
+
+    for (auto& thread_fds : fds) {
+        for (int fd : thread_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    fds.clear();
+    initialized = false;
+}
+
+Region::Region (perf_region region)
+    : m_region(region), m_active(false), m_start_time(0.0)
+{
+    if (!initialized) return;
+
+#ifdef _OPENMP
+    if (omp_in_parallel()) return;
+#endif
+
+    m_active = true;
+    m_start_time = ParallelDescriptor::second();
+    read_all(m_start);
+}
+
+Region::~Region ()
+{
+    if (!m_active) return;
+
+    std::vector<std::uint64_t> end;
+    read_all(end);
+
+    RegionTotals& tot = totals[m_region];
+
+    tot.calls += 1;
+    tot.wall_time += ParallelDescriptor::second() - m_start_time;
+
+    for (int t = 0; t < nthreads; ++t) {
+        for (int e = 0; e < num_events; ++e) {
+            const int idx = 3 * (t * num_events + e);
+
+            const double value = static_cast<double>(end[idx] - m_start[idx]);
+            const double enabled = static_cast<double>(end[idx+1] - m_start[idx+1]);
+            const double running = static_cast<double>(end[idx+2] - m_start[idx+2]);
+
+            // Scale up counts from counters that the kernel only had
+            // scheduled for part of the region.
+
+            if (running > 0.0) {
+                tot.counts[e] += value * (enabled / running);
+            }
+        }
+    }
+}
+
+}
+
+#endif
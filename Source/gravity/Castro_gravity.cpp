@@ -15,6 +15,13 @@ Castro::construct_old_gravity(int amr_iteration, int amr_ncycle, Real time)
 {
     BL_PROFILE("Castro::construct_old_gravity()");
 
+    // Without gravity there is no old-time data to fill; see
+    // old_data_needed().
+
+    if (!do_grav) {
+        return;
+    }
+
     MultiFab& grav_old = get_old_data(Gravity_Type);
     MultiFab& phi_old = get_old_data(PhiGrav_Type);
 
@@ -24,14 +31,6 @@ Castro::construct_old_gravity(int amr_iteration, int amr_ncycle, Real time)
     if (gravity->get_gravity_type() != "PoissonGrav")
         phi_old.setVal(0.0);
 
-    if (!do_grav) {
-
-        grav_old.setVal(0.0);
-
-        return;
-
-    }
-
     // Do level solve at beginning of time step in order to compute the
     // difference between the multilevel and the single level solutions.
     // Note that we don't need to do this solve for single-level runs,
@@ -236,11 +235,11 @@ void Castro::construct_old_gravity_source(MultiFab& source, MultiFab& state_in,
 
     const Real strt_time = ParallelDescriptor::second();
 
+    if (!do_grav) return;
+
     const MultiFab& phi_old = get_old_data(PhiGrav_Type);
     const MultiFab& grav_old = get_old_data(Gravity_Type);
 
-    if (!do_grav) return;
-
     // Gravitational source term for the time-level n data.
 
 #ifdef HYBRID_MOMENTUM
@@ -386,11 +385,11 @@ void Castro::construct_new_gravity_source(MultiFab& source, MultiFab& state_old,
 
     const Real strt_time = ParallelDescriptor::second();
 
+    if (!do_grav) return;
+
     MultiFab& grav_old = get_old_data(Gravity_Type);
     MultiFab& grav_new = get_new_data(Gravity_Type);
 
-    if (!do_grav) return;
-
     GpuArray<Real, 3> dx;
     for (int i = 0; i < AMREX_SPACEDIM; ++i) {
         dx[i] = geom.CellSizeArray()[i];
@@ -21,6 +21,7 @@
 
 #include <Gravity_util.H>
 #include <MGutils.H>
+#include <perf_counters.H>
 
 using namespace amrex;
 
@@ -1765,6 +1766,7 @@ void
 Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Vector<MultiFab*>& Rhs, MultiFab& phi)
 {
     BL_PROFILE("Gravity::fill_multipole_BCs()");
+    CASTRO_PERF_REGION(perf_multipole_bc);
 
     // Multipole BCs only make sense to construct if we are starting from the coarse level.
 
@@ -3370,6 +3372,7 @@ Gravity::solve_phi_with_mlmg (int crse_level, int fine_level,
                               Real time)
 {
     BL_PROFILE("Gravity::solve_phi_with_mlmg()");
+    CASTRO_PERF_REGION(perf_solve_phi);
 
     int nlevs = fine_level-crse_level+1;
 
@@ -2,6 +2,7 @@
 #include <Castro_util.H>
 #include <Castro_F.H>
 #include <Castro_hydro.H>
+#include <perf_counters.H>
 
 #ifdef RADIATION
 #include <Radiation.H>
@@ -14,10 +15,11 @@
 using namespace amrex;
 
 void
-Castro::construct_ctu_hydro_source(Real time, Real dt)
+Castro::construct_ctu_hydro_source(Real time, Real dt, MultiFab* source_halo)
 {
 
   BL_PROFILE("Castro::construct_ctu_hydro_source()");
+  CASTRO_PERF_REGION(perf_ctu_hydro);
 
   const Real strt_time = ParallelDescriptor::second();
 
@@ -27,7 +29,7 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
   if (verbose && ParallelDescriptor::IOProcessor())
     std::cout << "... Entering construct_ctu_hydro_source()" << std::endl << std::endl;
 
-  hydro_source.setVal(0.0);
+  numa_setval(hydro_source, 0.0);
 
 #ifdef HYBRID_MOMENTUM
   GeometryData geomdata = geom.data();
@@ -50,17 +52,33 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
 
   int nstep_fsp = -1;
 
+  MultiFab Erborder(grids, dmap, Radiation::nGroups, NUM_GROW);
   AmrLevel::FillPatch(*this, Erborder, NUM_GROW, time, Rad_Type, 0, Radiation::nGroups);
 
-  MultiFab lamborder(grids, dmap, Radiation::nGroups, NUM_GROW);
-  if (radiation->pure_hydro) {
-      lamborder.setVal(0.0, NUM_GROW);
-  }
-  else {
+  // A constant flux limiter is filled in per tile below.
+
+  MultiFab lamborder;
+  const bool constant_lambda = radiation->constant_limiter();
+  const Real lambda_value = radiation->constant_limiter_value();
+  if (!constant_lambda) {
+      lamborder.define(grids, dmap, Radiation::nGroups, NUM_GROW);
       radiation->compute_limiter(level, grids, Sborder, Erborder, lamborder);
   }
 #endif
 
+  // With source_halo the update is done in two passes, so that most
+  // of it overlaps the exchange of the ghost zones of the sources.
+
+  const int npasses = source_halo ? 2 : 1;
+
+  for (int pass = 0; pass < npasses; ++pass) {
+
+  if (pass == 1) {
+      finish_halo_fill(*source_halo, time, NUM_GROW, Source_Type, 0);
+      source_halo->setVal(0.0, 0, NSRC, 0);
+      MultiFab::Add(sources_for_hydro, *source_halo, 0, 0, NSRC, NUM_GROW);
+  }
+
 #ifdef _OPENMP
 #ifdef RADIATION
 #pragma omp parallel reduction(max:nstep_fsp)
@@ -80,9 +98,6 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
     // longer needed (only relevant for the asynchronous case, usually on GPUs).
 
     FArrayBox flatn;
-#ifdef RADIATION
-    FArrayBox flatg;
-#endif
     FArrayBox shk;
     FArrayBox q, qaux;
     FArrayBox src_q;
@@ -97,6 +112,7 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
     FArrayBox q_int;
 #ifdef RADIATION
     FArrayBox lambda_int;
+    FArrayBox lam;
 #endif
 #if AMREX_SPACEDIM >= 2
     FArrayBox ftmp1, ftmp2;
@@ -127,22 +143,48 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
     size_t current_size = starting_size;
 #endif
 
-    for (MFIter mfi(S_new, hydro_tile_size); mfi.isValid(); ++mfi) {
+    for (MFIter mfi(S_new, tile_size(tile_family_hydro)); mfi.isValid(); ++mfi) {
+
+      const Box& tbx = mfi.tilebox();
+      const Box& vbx = mfi.validbox();
+
+      // With two passes, the first updates the part of the tile whose
+      // stencil stays within the valid box, and the second the rest.
+
+      BoxList pass_boxes(tbx);
+
+      if (npasses == 2) {
+          const Box inner = tbx & amrex::grow(vbx, -NUM_GROW);
+          if (pass == 0) {
+              pass_boxes = inner.ok() ? BoxList(inner) : BoxList();
+          }
+          else if (inner.ok()) {
+              pass_boxes = amrex::boxDiff(tbx, inner);
+          }
+      }
+
+      for (const Box& bx : pass_boxes) {
 
       size_t fab_size = 0;
 
-      // the valid region box
-      const Box& bx = mfi.tilebox();
+      // the faces of bx whose fluxes it adds to the level fluxes; as
+      // with the nodal tile boxes, the high face only at the high end
+      // of the valid box, so that each face is added once
+
+      const auto nodal_box = [&] (int idir) -> Box
+      {
+          Box nbx = amrex::surroundingNodes(bx, idir);
+          if (bx.bigEnd(idir) < vbx.bigEnd(idir)) {
+              nbx.growHi(idir, -1);
+          }
+          return nbx;
+      };
 
       const Box& obx = amrex::grow(bx, 1);
 
       flatn.resize(obx, 1, The_Async_Arena());
       fab_size += flatn.nBytes();
 
-#ifdef RADIATION
-      flatg.resize(obx, 1, The_Async_Arena());
-      fab_size += flatg.nBytes();
-#endif
 
       // If we are oversubscribing the GPU, performance of the hydro will be constrained
       // due to its heavy memory requirements. We can help the situation by prefetching in
@@ -191,9 +233,22 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
       fab_size += qaux.nBytes();
       Array4<Real> const qaux_arr = qaux.array();
 
+#ifdef RADIATION
+      Array4<Real const> lam_arr;
+      if (constant_lambda) {
+          lam.resize(qbx, Radiation::nGroups, The_Async_Arena());
+          fab_size += lam.nBytes();
+          lam.setVal<RunOn::Device>(lambda_value);
+          lam_arr = lam.const_array();
+      }
+      else {
+          lam_arr = lamborder.const_array(mfi);
+      }
+#endif
+
       ctoprim(qbx, time, Sborder.array(mfi),
 #ifdef RADIATION
-              Erborder.array(mfi), lamborder.array(mfi),
+              Erborder.array(mfi), lam_arr,
 #endif
               q_arr, qaux_arr);
 
@@ -213,52 +268,21 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
       Array4<Real const> const dLogArea_arr = (dLogArea[0]).array(mfi);
 #endif
 
-      // compute the flattening coefficient
-
-      Array4<Real> const flatn_arr = flatn.array();
-#ifdef RADIATION
-      Array4<Real> const flatg_arr = flatg.array();
-#endif
-
-      if (first_order_hydro == 1) {
-        amrex::ParallelFor(obx,
-        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-        {
-          flatn_arr(i,j,k) = 0.0;
-        });
-      } else if (use_flattening == 1) {
-
-        uflatten(obx, q_arr, flatn_arr, QPRES);
-
-#ifdef RADIATION
-        uflatten(obx, q_arr, flatg_arr, QPTOT);
-
-        Real flatten_pp_thresh = radiation::flatten_pp_threshold;
+      // compute the flattening coefficient, the shock flag (used by
+      // the hybrid Riemann solver) and div{U} (used later for the
+      // artificial viscosity) in one pass over q
 
-        amrex::ParallelFor(obx,
-        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-        {
-          flatn_arr(i,j,k) = flatn_arr(i,j,k) * flatg_arr(i,j,k);
+      shk.resize(obx, 1, The_Async_Arena());
+      fab_size += shk.nBytes();
 
-          if (flatten_pp_thresh > 0.0) {
-            if ( q_arr(i-1,j,k,QU) + q_arr(i,j-1,k,QV) + q_arr(i,j,k-1,QW) >
-                 q_arr(i+1,j,k,QU) + q_arr(i,j+1,k,QV) + q_arr(i,j,k+1,QW) ) {
+      div.resize(obx, 1, The_Async_Arena());
+      fab_size += div.nBytes();
 
-              if (q_arr(i,j,k,QPRES) < flatten_pp_thresh * q_arr(i,j,k,QPTOT)) {
-                flatn_arr(i,j,k) = 0.0;
-              }
-            }
-          }
-        });
-#endif
+      Array4<Real> const flatn_arr = flatn.array();
+      Array4<Real> const shk_arr = shk.array();
+      auto div_arr = div.array();
 
-      } else {
-        amrex::ParallelFor(obx,
-        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-        {
-          flatn_arr(i,j,k) = 1.0;
-        });
-      }
+      shock_flatten_divu(obx, q_arr, flatn_arr, shk_arr, div_arr, 1);
 
       const Box& xbx = amrex::surroundingNodes(bx, 0);
       const Box& gxbx = amrex::grow(xbx, 1);
@@ -271,31 +295,6 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
       const Box& gzbx = amrex::grow(zbx, 1);
 #endif
 
-      shk.resize(obx, 1, The_Async_Arena());
-      fab_size += shk.nBytes();
-
-      Array4<Real> const shk_arr = shk.array();
-
-      // Multidimensional shock detection
-      // Used for the hybrid Riemann solver
-
-#ifdef SHOCK_VAR
-      bool compute_shock = true;
-#else
-      bool compute_shock = false;
-#endif
-
-      if (hybrid_riemann == 1 || compute_shock) {
-        shock(obx, q_arr, shk_arr);
-      }
-      else {
-        amrex::ParallelFor(obx,
-        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-        {
-          shk_arr(i,j,k) = 0.0;
-        });
-      }
-
       // get the primitive variable hydro sources
 
       src_q.resize(qbx, NQSRC, The_Async_Arena());
@@ -413,13 +412,6 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
 
       }
 
-      div.resize(obx, 1, The_Async_Arena());
-      fab_size += div.nBytes();
-      auto div_arr = div.array();
-
-      // compute divu -- we'll use this later when doing the artifical viscosity
-      divu(obx, q_arr, div_arr);
-
       q_int.resize(obx, NQ, The_Async_Arena());
       fab_size += q_int.nBytes();
       Array4<Real> const q_int_arr = q_int.array();
@@ -1129,6 +1121,13 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
 #endif
           });
 
+          // Replace the passive fluxes with ones advected by the final
+          // mass flux; the tracing carried the passives at first order.
+
+          if (lightweight_passives == 1) {
+              passive_upwind_fluxes(nbx, idir, q.array(), flatn.array(), flux_arr, dt);
+          }
+
           apply_av(nbx, idir, div_arr, uin_arr, flux_arr);
 
 #ifdef RADIATION
@@ -1306,21 +1305,22 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
             Array4<Real> fluxes_fab = (*fluxes[idir]).array(mfi);
             const int numcomp = NUM_STATE;
 
-            AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(idir), numcomp, i, j, k, n,
+            AMREX_HOST_DEVICE_FOR_4D(nodal_box(idir), numcomp, i, j, k, n,
             {
                 fluxes_fab(i,j,k,n) += flux_fab(i,j,k,n);
             });
 
 #ifdef RADIATION
-            Array4<Real> const rad_flux_fab = (rad_flux[idir]).array();
-            Array4<Real> rad_fluxes_fab = (*rad_fluxes[idir]).array(mfi);
-            const int radcomp = Radiation::nGroups;
-
-            AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(idir), radcomp, i, j, k, n,
-            {
-                rad_fluxes_fab(i,j,k,n) += rad_flux_fab(i,j,k,n);
-            });
+            if (rad_fluxes[idir]) {
+                Array4<Real> const rad_flux_fab = (rad_flux[idir]).array();
+                Array4<Real> rad_fluxes_fab = (*rad_fluxes[idir]).array(mfi);
+                const int radcomp = Radiation::nGroups;
 
+                AMREX_HOST_DEVICE_FOR_4D(nodal_box(idir), radcomp, i, j, k, n,
+                {
+                    rad_fluxes_fab(i,j,k,n) += rad_flux_fab(i,j,k,n);
+                });
+            }
 #endif
 
 #if AMREX_SPACEDIM <= 2
@@ -1333,7 +1333,7 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
                 Array4<Real> pradial_fab = pradial.array();
                 Array4<Real> P_radial_fab = P_radial.array(mfi);
 
-                AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(0), 1, i, j, k, n,
+                AMREX_HOST_DEVICE_FOR_4D(nodal_box(0), 1, i, j, k, n,
                 {
                     P_radial_fab(i,j,k,0) += pradial_fab(i,j,k,0);
                 });
@@ -1346,7 +1346,7 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
         Array4<Real> const flux_fab = (flux[idir]).array();
         Array4<Real> mass_fluxes_fab = (*mass_fluxes[idir]).array(mfi);
 
-        AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(idir), 1, i, j, k, n,
+        AMREX_HOST_DEVICE_FOR_4D(nodal_box(idir), 1, i, j, k, n,
         {
             // This is a copy, not an add, since we need mass_fluxes to be
             // only this subcycle's data when we evaluate the gravitational
@@ -1400,10 +1400,14 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
       }
 
 
+      } // pass_boxes loop
+
     } // MFIter loop
 
   } // OMP loop
 
+  } // pass loop
+
 #ifdef RADIATION
   if (radiation->verbose>=1) {
 #ifdef BL_LAZY
@@ -1426,6 +1430,8 @@ Castro::construct_ctu_hydro_source(Real time, Real dt)
   }
 #endif
 
+  record_tile_time(tile_family_hydro, ParallelDescriptor::second() - strt_time);
+
   if (verbose && ParallelDescriptor::IOProcessor())
     std::cout << "... Leaving construct_ctu_hydro_source()" << std::endl << std::endl;
 
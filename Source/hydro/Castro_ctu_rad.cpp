@@ -68,6 +68,14 @@ Castro::ctu_rad_consup(const Box& bx,
   int limiter = Radiation::limiter;
   int closure = Radiation::closure;
 
+  const Real dxinv = 1.0_rt / dx[0];
+#if AMREX_SPACEDIM >= 2
+  const Real dyinv = 1.0_rt / dx[1];
+#endif
+#if AMREX_SPACEDIM == 3
+  const Real dzinv = 1.0_rt / dx[2];
+#endif
+
   // radiation energy update.  For the moment, we actually update things
   // fully here, instead of creating a source term for the update
   amrex::ParallelFor(bx, NGROUPS,
@@ -85,13 +93,19 @@ Castro::ctu_rad_consup(const Box& bx,
          ) / vol(i,j,k);
   });
 
-  // Add gradp term to momentum equation -- only for axisymmetry coords
-  // (and only for the radial flux);  also add the radiation pressure gradient
-  // to the momentum for all directions
-  amrex::ParallelFor(bx,
-  [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+  // The remaining updates are done in a single pass over the zones.
+  // The cell-centered lambda is computed only once per zone and shared
+  // between the radiation pressure gradient and the comoving-frame
+  // source.  The update returns the number of frequency-space substeps
+  // the zone needed, which is only reduced in the comoving case.
+
+  auto zone_update = [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> int
   {
 
+    // Add gradp term to momentum equation -- only for axisymmetry coords
+    // (and only for the radial flux);  also add the radiation pressure gradient
+    // to the momentum for all directions
+
     // pgdnv from the Riemann solver is only the gas contribution,
     // not the radiation contribution.  Note that we've already included
     // the gas pressure in the momentum flux for all Cartesian coordinate
@@ -99,7 +113,7 @@ Castro::ctu_rad_consup(const Box& bx,
 
     Real dpdx = 0;
     if (!mom_flux_has_p(0, 0, coord_type)) {
-      dpdx = (qx(i+1,j,k,GDPRES) - qx(i,j,k,GDPRES))/ dx[0];
+      dpdx = (qx(i+1,j,k,GDPRES) - qx(i,j,k,GDPRES)) * dxinv;
       update(i,j,k,UMX) -= dpdx;
     }
 
@@ -108,28 +122,30 @@ Castro::ctu_rad_consup(const Box& bx,
     Real dprdy = 0.0;
     Real dprdz = 0.0;
 
-    Real lamc = 0.0;
+    // cell-centered lambda, reused below for the comoving terms
+    Real lamc[NGROUPS];
+
     for (int g = 0; g < NGROUPS; g++) {
 
 #if AMREX_SPACEDIM == 1
-      lamc = 0.5_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g));
+      lamc[g] = 0.5_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g));
 #endif
 #if AMREX_SPACEDIM == 2
-      lamc = 0.25_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
-                        qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g));
+      lamc[g] = 0.25_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
+                           qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g));
 #endif
 #if AMREX_SPACEDIM == 3
-      lamc = (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
-              qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g) +
-              qz(i,j,k,GDLAMS+g) + qz(i,j,k+1,GDLAMS+g)) / 6.0_rt;
+      lamc[g] = (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
+                 qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g) +
+                 qz(i,j,k,GDLAMS+g) + qz(i,j,k+1,GDLAMS+g)) / 6.0_rt;
 #endif
 
-      dprdx = dprdx + lamc * (qx(i+1,j,k,GDERADS+g) - qx(i,j,k,GDERADS+g))/dx[0];
+      dprdx = dprdx + lamc[g] * (qx(i+1,j,k,GDERADS+g) - qx(i,j,k,GDERADS+g)) * dxinv;
 #if AMREX_SPACEDIM >= 2
-      dprdy = dprdy + lamc * (qy(i,j+1,k,GDERADS+g) - qy(i,j,k,GDERADS+g))/dx[1];
+      dprdy = dprdy + lamc[g] * (qy(i,j+1,k,GDERADS+g) - qy(i,j,k,GDERADS+g)) * dyinv;
 #endif
 #if AMREX_SPACEDIM == 3
-      dprdz = dprdz + lamc * (qz(i,j,k+1,GDERADS+g) - qz(i,j,k,GDERADS+g))/dx[2];
+      dprdz = dprdz + lamc[g] * (qz(i,j,k+1,GDERADS+g) - qz(i,j,k,GDERADS+g)) * dzinv;
 #endif
     }
 
@@ -173,174 +189,171 @@ Castro::ctu_rad_consup(const Box& bx,
     if (! comov) {
       // ! mixed-frame (single group only)
       Erout(i,j,k,0) = Erout(i,j,k,0) - dek;
-    }
-
-  });
-
-
-  // Add radiation source terms to rho*u, rhoE, and Er
 
-  if (comov) {
-
-    ReduceOps<ReduceOpMax> reduce_op;
-    ReduceData<Real> reduce_data(reduce_op);
-    using ReduceTuple = typename decltype(reduce_data)::Type;
+      return 1;
+    }
 
-    reduce_op.eval(bx, reduce_data,
-    [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
-    {
+    // Add radiation source terms to rho*u, rhoE, and Er
 
-      Real ux = 0.5_rt * (qx(i,j,k,GDU) + qx(i+1,j,k,GDU));
+    Real ux = 0.5_rt * (qx(i,j,k,GDU) + qx(i+1,j,k,GDU));
 #if AMREX_SPACEDIM >= 2
-      Real uy = 0.5_rt * (qy(i,j,k,GDV) + qy(i,j+1,k,GDV));
+    Real uy = 0.5_rt * (qy(i,j,k,GDV) + qy(i,j+1,k,GDV));
 #endif
 #if AMREX_SPACEDIM == 3
-      Real uz = 0.5_rt * (qz(i,j,k,GDW) + qz(i,j,k+1,GDW));
+    Real uz = 0.5_rt * (qz(i,j,k,GDW) + qz(i,j,k+1,GDW));
 #endif
 
-      Real dudx[3] = {0, 0, 0};
-      Real dudy[3] = {0, 0, 0};
-      Real dudz[3] = {0, 0, 0};
+    Real dudx[3] = {0, 0, 0};
+    Real dudy[3] = {0, 0, 0};
+    Real dudz[3] = {0, 0, 0};
 
-      dudx[0] = (qx(i+1,j,k,GDU) - qx(i,j,k,GDU))/dx[0];
-      dudx[1] = (qx(i+1,j,k,GDV) - qx(i,j,k,GDV))/dx[0];
-      dudx[2] = (qx(i+1,j,k,GDW) - qx(i,j,k,GDW))/dx[0];
+    dudx[0] = (qx(i+1,j,k,GDU) - qx(i,j,k,GDU)) * dxinv;
+    dudx[1] = (qx(i+1,j,k,GDV) - qx(i,j,k,GDV)) * dxinv;
+    dudx[2] = (qx(i+1,j,k,GDW) - qx(i,j,k,GDW)) * dxinv;
 
 #if AMREX_SPACEDIM >= 2
-      dudy[0] = (qy(i,j+1,k,GDU) - qy(i,j,k,GDU))/dx[1];
-      dudy[1] = (qy(i,j+1,k,GDV) - qy(i,j,k,GDV))/dx[1];
-      dudy[2] = (qy(i,j+1,k,GDW) - qy(i,j,k,GDW))/dx[1];
+    dudy[0] = (qy(i,j+1,k,GDU) - qy(i,j,k,GDU)) * dyinv;
+    dudy[1] = (qy(i,j+1,k,GDV) - qy(i,j,k,GDV)) * dyinv;
+    dudy[2] = (qy(i,j+1,k,GDW) - qy(i,j,k,GDW)) * dyinv;
 #endif
 
 #if AMREX_SPACEDIM == 3
-      dudz[0] = (qz(i,j,k+1,GDU) - qz(i,j,k,GDU))/dx[2];
-      dudz[1] = (qz(i,j,k+1,GDV) - qz(i,j,k,GDV))/dx[2];
-      dudz[2] = (qz(i,j,k+1,GDW) - qz(i,j,k,GDW))/dx[2];
+    dudz[0] = (qz(i,j,k+1,GDU) - qz(i,j,k,GDU)) * dzinv;
+    dudz[1] = (qz(i,j,k+1,GDV) - qz(i,j,k,GDV)) * dzinv;
+    dudz[2] = (qz(i,j,k+1,GDW) - qz(i,j,k,GDW)) * dzinv;
 #endif
 
-      Real divu = dudx[0] + dudy[1] + dudz[2];
+    Real divu = dudx[0] + dudy[1] + dudz[2];
 
-      // Note that for single group, fspace_type is always 1
-      Real af[NGROUPS];
+    // Note that for single group, fspace_type is always 1
+    Real af[NGROUPS];
 
-      for (int g = 0; g < NGROUPS; g++) {
+    for (int g = 0; g < NGROUPS; g++) {
 
-        Real nhat[3] = {0., 0., 0.};
+      Real nhat[3] = {0., 0., 0.};
 
-        nhat[0] = (qx(i+1,j,k,GDERADS+g) - qx(i,j,k,GDERADS+g))/dx[0];
+      nhat[0] = (qx(i+1,j,k,GDERADS+g) - qx(i,j,k,GDERADS+g)) * dxinv;
 #if AMREX_SPACEDIM >= 2
-        nhat[1] = (qy(i,j+1,k,GDERADS+g) - qy(i,j,k,GDERADS+g))/dx[1];
+      nhat[1] = (qy(i,j+1,k,GDERADS+g) - qy(i,j,k,GDERADS+g)) * dyinv;
 #endif
 #if AMREX_SPACEDIM == 3
-        nhat[2] = (qz(i,j,k+1,GDERADS+g) - qz(i,j,k,GDERADS+g))/dx[2];
+      nhat[2] = (qz(i,j,k+1,GDERADS+g) - qz(i,j,k,GDERADS+g)) * dzinv;
 #endif
 
-        Real GnDotu[3];
-
-        GnDotu[0] = nhat[0] * dudx[0] + nhat[1] * dudx[1] + nhat[2] * dudx[2];
-        GnDotu[1] = nhat[0] * dudy[0] + nhat[1] * dudy[1] + nhat[2] * dudy[2];
-        GnDotu[2] = nhat[0] * dudz[0] + nhat[1] * dudz[1] + nhat[2] * dudz[2];
+      Real GnDotu[3];
 
-        Real nnColonDotGu = (nhat[0] * GnDotu[0] + nhat[1] * GnDotu[1] + nhat[2] * GnDotu[2]) /
-          (nhat[0] * nhat[0] + nhat[1] * nhat[1] + nhat[2] * nhat[2] + 1.e-50_rt);
+      GnDotu[0] = nhat[0] * dudx[0] + nhat[1] * dudx[1] + nhat[2] * dudx[2];
+      GnDotu[1] = nhat[0] * dudy[0] + nhat[1] * dudy[1] + nhat[2] * dudy[2];
+      GnDotu[2] = nhat[0] * dudz[0] + nhat[1] * dudz[1] + nhat[2] * dudz[2];
 
-        Real lamc;
-#if AMREX_SPACEDIM == 1
-        lamc = 0.5_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g));
-#endif
-#if AMREX_SPACEDIM == 2
-        lamc = 0.25_rt * (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
-                          qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g));
-#endif
-#if AMREX_SPACEDIM == 3
-        lamc = (qx(i,j,k,GDLAMS+g) + qx(i+1,j,k,GDLAMS+g) +
-                qy(i,j,k,GDLAMS+g) + qy(i,j+1,k,GDLAMS+g) +
-                qz(i,j,k,GDLAMS+g) + qz(i,j,k+1,GDLAMS+g) ) / 6.0_rt;
-#endif
+      Real nnColonDotGu = (nhat[0] * GnDotu[0] + nhat[1] * GnDotu[1] + nhat[2] * GnDotu[2]) /
+        (nhat[0] * nhat[0] + nhat[1] * nhat[1] + nhat[2] * nhat[2] + 1.e-50_rt);
 
-        Real Eddf = Edd_factor(lamc, limiter, closure);
-        Real f1 = (1.0_rt - Eddf) * 0.5_rt;
-        Real f2 = (3.0_rt * Eddf - 1.0_rt) * 0.5_rt;
-        af[g] = -(f1*divu + f2*nnColonDotGu);
+      Real Eddf = Edd_factor(lamc[g], limiter, closure);
+      Real f1 = (1.0_rt - Eddf) * 0.5_rt;
+      Real f2 = (3.0_rt * Eddf - 1.0_rt) * 0.5_rt;
+      af[g] = -(f1*divu + f2*nnColonDotGu);
 
-        if (fspace_type == 1) {
-          Real Eddfxp = Edd_factor(qx(i+1,j,k,GDLAMS+g), limiter, closure);
-          Real Eddfxm = Edd_factor(qx(i,j,k,GDLAMS+g), limiter, closure);
+      if (fspace_type == 1) {
+        Real Eddfxp = Edd_factor(qx(i+1,j,k,GDLAMS+g), limiter, closure);
+        Real Eddfxm = Edd_factor(qx(i,j,k,GDLAMS+g), limiter, closure);
 #if AMREX_SPACEDIM >= 2
-          Real Eddfyp = Edd_factor(qy(i,j+1,k,GDLAMS+g), limiter, closure);
-          Real Eddfym = Edd_factor(qy(i,j,k,GDLAMS+g), limiter, closure);
+        Real Eddfyp = Edd_factor(qy(i,j+1,k,GDLAMS+g), limiter, closure);
+        Real Eddfym = Edd_factor(qy(i,j,k,GDLAMS+g), limiter, closure);
 #endif
 #if AMREX_SPACEDIM == 3
-          Real Eddfzp = Edd_factor(qz(i,j,k+1,GDLAMS+g), limiter, closure);
-          Real Eddfzm = Edd_factor(qz(i,j,k,GDLAMS+g), limiter, closure);
+        Real Eddfzp = Edd_factor(qz(i,j,k+1,GDLAMS+g), limiter, closure);
+        Real Eddfzm = Edd_factor(qz(i,j,k,GDLAMS+g), limiter, closure);
 #endif
 
-          Real f1xp = 0.5_rt * (1.0_rt - Eddfxp);
-          Real f1xm = 0.5_rt * (1.0_rt - Eddfxm);
+        Real f1xp = 0.5_rt * (1.0_rt - Eddfxp);
+        Real f1xm = 0.5_rt * (1.0_rt - Eddfxm);
 #if AMREX_SPACEDIM >= 2
-          Real f1yp = 0.5_rt * (1.0_rt - Eddfyp);
-          Real f1ym = 0.5_rt * (1.0_rt - Eddfym);
+        Real f1yp = 0.5_rt * (1.0_rt - Eddfyp);
+        Real f1ym = 0.5_rt * (1.0_rt - Eddfym);
 #endif
 #if AMREX_SPACEDIM == 3
-          Real f1zp = 0.5_rt * (1.0_rt - Eddfzp);
-          Real f1zm = 0.5_rt * (1.0_rt - Eddfzm);
+        Real f1zp = 0.5_rt * (1.0_rt - Eddfzp);
+        Real f1zm = 0.5_rt * (1.0_rt - Eddfzm);
 #endif
 
-          Real Gf1E[3];
+        Real Gf1E[3];
 
-          Gf1E[0] = (f1xp*qx(i+1,j,k,GDERADS+g) - f1xm*qx(i,j,k,GDERADS+g)) / dx[0];
+        Gf1E[0] = (f1xp*qx(i+1,j,k,GDERADS+g) - f1xm*qx(i,j,k,GDERADS+g)) * dxinv;
 #if AMREX_SPACEDIM >= 2
-          Gf1E[1] = (f1yp*qy(i,j+1,k,GDERADS+g) - f1ym*qy(i,j,k,GDERADS+g)) / dx[1];
+        Gf1E[1] = (f1yp*qy(i,j+1,k,GDERADS+g) - f1ym*qy(i,j,k,GDERADS+g)) * dyinv;
 #endif
 #if AMREX_SPACEDIM == 3
-          Gf1E[2] = (f1zp*qz(i,j,k+1,GDERADS+g) - f1zm*qz(i,j,k,GDERADS+g)) / dx[2];
+        Gf1E[2] = (f1zp*qz(i,j,k+1,GDERADS+g) - f1zm*qz(i,j,k,GDERADS+g)) * dzinv;
 #endif
 
 
 #if AMREX_SPACEDIM == 1
-          Real Egdc = 0.5_rt * (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g));
-          Erout(i,j,k,g) = Erout(i,j,k,g) + dt * ux * Gf1E[0]
-            - dt * f2 * Egdc * nnColonDotGu;
+        Real Egdc = 0.5_rt * (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g));
+        Erout(i,j,k,g) = Erout(i,j,k,g) + dt * ux * Gf1E[0]
+          - dt * f2 * Egdc * nnColonDotGu;
 #endif
 #if AMREX_SPACEDIM == 2
-          Real Egdc = 0.25_rt * (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g) +
-                                 qy(i,j,k,GDERADS+g) + qy(i,j+1,k,GDERADS+g));
-          Erout(i,j,k,g) = Erout(i,j,k,g) + dt * (ux * Gf1E[0] + uy * Gf1E[1])
-            - dt * f2 * Egdc * nnColonDotGu;
+        Real Egdc = 0.25_rt * (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g) +
+                               qy(i,j,k,GDERADS+g) + qy(i,j+1,k,GDERADS+g));
+        Erout(i,j,k,g) = Erout(i,j,k,g) + dt * (ux * Gf1E[0] + uy * Gf1E[1])
+          - dt * f2 * Egdc * nnColonDotGu;
 #endif
 #if AMREX_SPACEDIM == 3
-          Real Egdc = (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g) +
-                       qy(i,j,k,GDERADS+g) + qy(i,j+1,k,GDERADS+g) +
-                       qz(i,j,k,GDERADS+g) + qz(i,j,k+1,GDERADS+g) ) / 6.0_rt;
-          Erout(i,j,k,g) = Erout(i,j,k,g) + dt * (ux * Gf1E[0] + uy * Gf1E[1] + uz * Gf1E[2])
-            - dt * f2 * Egdc * nnColonDotGu;
+        Real Egdc = (qx(i,j,k,GDERADS+g) + qx(i+1,j,k,GDERADS+g) +
+                     qy(i,j,k,GDERADS+g) + qy(i,j+1,k,GDERADS+g) +
+                     qz(i,j,k,GDERADS+g) + qz(i,j,k+1,GDERADS+g) ) / 6.0_rt;
+        Erout(i,j,k,g) = Erout(i,j,k,g) + dt * (ux * Gf1E[0] + uy * Gf1E[1] + uz * Gf1E[2])
+          - dt * f2 * Egdc * nnColonDotGu;
 #endif
 
-        }
       }
+    }
 
-      int nstep_fsp_tmp = 1;
+    int nstep_fsp_tmp = 1;
 
-      if (NGROUPS > 1) {
-        Real ustar[NGROUPS];
-        for (int g = 0; g < NGROUPS; g++) { 
-          ustar[g] = Erout(i,j,k,g) / Erscale[g];
-        }
+    if (NGROUPS > 1) {
+      Real ustar[NGROUPS];
+      for (int g = 0; g < NGROUPS; g++) {
+        ustar[g] = Erout(i,j,k,g) / Erscale[g];
+      }
 
-        update_one_species(NGROUPS, ustar, af, dlognu.begin(), dt, nstep_fsp_tmp);
+      update_one_species(NGROUPS, ustar, af, dlognu.begin(), dt, nstep_fsp_tmp);
 
-        for (int g = 0; g < NGROUPS; g++) {
-          Erout(i,j,k,g) = ustar[g] * Erscale[g];
-        }
+      for (int g = 0; g < NGROUPS; g++) {
+        Erout(i,j,k,g) = ustar[g] * Erscale[g];
       }
+    }
 
-      return nstep_fsp_tmp;
+    return nstep_fsp_tmp;
+
+  };
+
+  if (comov) {
 
+    // We use a reduction here since we need the maximum number of
+    // frequency-space substeps.
+
+    ReduceOps<ReduceOpMax> reduce_op;
+    ReduceData<int> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    reduce_op.eval(bx, reduce_data,
+    [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
+    {
+      return {zone_update(i,j,k)};
     });
 
     ReduceTuple hv = reduce_data.value();
     nstep_fsp = amrex::get<0>(hv);
 
+  } else {
+
+    amrex::ParallelFor(bx,
+    [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+    {
+      zone_update(i,j,k);
+    });
+
   }
 }
-
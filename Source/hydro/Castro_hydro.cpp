@@ -15,13 +15,16 @@ Castro::cons_to_prim(const Real time)
     BL_PROFILE("Castro::cons_to_prim()");
     
 #ifdef RADIATION
+    MultiFab Erborder(grids, dmap, Radiation::nGroups, NUM_GROW);
     AmrLevel::FillPatch(*this, Erborder, NUM_GROW, time, Rad_Type, 0, Radiation::nGroups);
 
-    MultiFab lamborder(grids, dmap, Radiation::nGroups, NUM_GROW);
-    if (radiation->pure_hydro) {
-      lamborder.setVal(0.0, NUM_GROW);
-    }
-    else {
+    // A constant flux limiter is filled in per tile below.
+
+    MultiFab lamborder;
+    const bool constant_lambda = radiation->constant_limiter();
+    const Real lambda_value = radiation->constant_limiter_value();
+    if (!constant_lambda) {
+      lamborder.define(grids, dmap, Radiation::nGroups, NUM_GROW);
       radiation->compute_limiter(level, grids, Sborder, Erborder, lamborder);
     }
 #endif
@@ -40,7 +43,17 @@ Castro::cons_to_prim(const Real time)
         Array4<Real> const Sborder_arr = Sborder.array(mfi);
 #ifdef RADIATION
         Array4<Real> const Erborder_arr = Erborder.array(mfi);
-        Array4<Real> const lamborder_arr = lamborder.array(mfi);
+
+        FArrayBox lam;
+        Array4<Real const> lamborder_arr;
+        if (constant_lambda) {
+          lam.resize(qbx, Radiation::nGroups, The_Async_Arena());
+          lam.setVal<RunOn::Device>(lambda_value);
+          lamborder_arr = lam.const_array();
+        }
+        else {
+          lamborder_arr = lamborder.const_array(mfi);
+        }
 #endif
 
         // Convert the conservative state to the primitive variable state.
@@ -75,13 +88,16 @@ Castro::cons_to_prim(MultiFab& u, MultiFab& q_in, MultiFab& qaux_in, Real time)
     int ng = q_in.nGrow();
 
 #ifdef RADIATION
+    MultiFab Erborder(grids, dmap, Radiation::nGroups, NUM_GROW);
     AmrLevel::FillPatch(*this, Erborder, NUM_GROW, time, Rad_Type, 0, Radiation::nGroups);
 
-    MultiFab lamborder(grids, dmap, Radiation::nGroups, NUM_GROW);
-    if (radiation->pure_hydro) {
-      lamborder.setVal(0.0, NUM_GROW);
-    }
-    else {
+    // A constant flux limiter is filled in per tile below.
+
+    MultiFab lamborder;
+    const bool constant_lambda = radiation->constant_limiter();
+    const Real lambda_value = radiation->constant_limiter_value();
+    if (!constant_lambda) {
+      lamborder.define(grids, dmap, Radiation::nGroups, NUM_GROW);
       radiation->compute_limiter(level, grids, Sborder, Erborder, lamborder);
     }
 #endif
@@ -96,7 +112,17 @@ Castro::cons_to_prim(MultiFab& u, MultiFab& q_in, MultiFab& qaux_in, Real time)
         auto u_arr = u.array(mfi);
 #ifdef RADIATION
         auto Erborder_arr = Erborder.array(mfi);
-        auto lamborder_arr = lamborder.array(mfi);
+
+        FArrayBox lam;
+        Array4<Real const> lamborder_arr;
+        if (constant_lambda) {
+          lam.resize(bx, Radiation::nGroups, The_Async_Arena());
+          lam.setVal<RunOn::Device>(lambda_value);
+          lamborder_arr = lam.const_array();
+        }
+        else {
+          lamborder_arr = lamborder.const_array(mfi);
+        }
 #endif
         auto q_in_arr = q_in.array(mfi);
         auto qaux_in_arr = qaux_in.array(mfi);
@@ -332,7 +358,17 @@ Castro::check_for_cfl_violation(const MultiFab& State, const Real dt)
 
                 // CTU integration constraint
 
-                return {amrex::max(courx, coury, courz)};
+                Real courtmp = amrex::max(courx, coury, courz);
+
+                // The lightweight passive update has no transverse
+                // corrections, so it is only stable for an advective
+                // Courant number summed over the directions below one.
+
+                if (castro::lightweight_passives == 1) {
+                    courtmp = amrex::max(courtmp, std::abs(u) * dtdx + std::abs(v) * dtdy + std::abs(w) * dtdz);
+                }
+
+                return {courtmp};
 
             }
             else {
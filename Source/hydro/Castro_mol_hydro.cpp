@@ -78,7 +78,7 @@ Castro::construct_mol_hydro_source(Real time, Real dt, MultiFab& A_update)
     FArrayBox avis;
 
     // The fourth order stuff cannot do tiling because of the Laplacian corrections
-    for (MFIter mfi(S_new, (sdc_order == 4) ? no_tile_size : hydro_tile_size); mfi.isValid(); ++mfi)
+    for (MFIter mfi(S_new, (sdc_order == 4) ? no_tile_size : tile_size(tile_family_hydro)); mfi.isValid(); ++mfi)
       {
         const Box& bx  = mfi.tilebox();
 
@@ -103,55 +103,27 @@ Castro::construct_mol_hydro_source(Real time, Real dt, MultiFab& A_update)
           stage_weight = node_weights[current_sdc_node];
         }
 
-        // get the flattening coefficient
+        // get the flattening coefficient, the shock variable and, for
+        // the second-order method, div{U} (used for the artificial
+        // viscosity) in one pass over q
+
         flatn.resize(obx, 1);
         Elixir elix_flatn = flatn.elixir();
 
-        Array4<Real const> const q_arr = q.array(mfi);
-        Array4<Real> const flatn_arr = flatn.array();
-
-        if (first_order_hydro == 1) {
-          amrex::ParallelFor(obx,
-          [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-          {
-            flatn_arr(i,j,k) = 0.0;
-          });
-        } else if (use_flattening == 1) {
-          uflatten(obx, q_arr, flatn_arr, QPRES);
-        } else {
-          amrex::ParallelFor(obx,
-          [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-          {
-            flatn_arr(i,j,k) = 1.0;
-          });
-        }
-
-        // get the interface states and shock variable
-
         shk.resize(obx, 1);
         Elixir elix_shk = shk.elixir();
 
-        Array4<Real> const shk_arr = shk.array();
+        const int compute_div = (sdc_order != 4 && do_hydro) ? 1 : 0;
 
-        // Multidimensional shock detection
-        // Used for the hybrid Riemann solver
+        div.resize(obx, 1);
+        Elixir elix_div = div.elixir();
 
-#ifdef SHOCK_VAR
-        bool compute_shock = true;
-#else
-        bool compute_shock = false;
-#endif
+        Array4<Real const> const q_arr = q.array(mfi);
+        Array4<Real> const flatn_arr = flatn.array();
+        Array4<Real> const shk_arr = shk.array();
+        auto div_arr = div.array();
 
-        if (hybrid_riemann == 1 || compute_shock) {
-          shock(obx, q_arr, shk_arr);
-        }
-        else {
-          amrex::ParallelFor(obx,
-          [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-          {
-            shk_arr(i,j,k) = 0.0;
-          });
-        }
+        shock_flatten_divu(obx, q_arr, flatn_arr, shk_arr, div_arr, compute_div);
 
         const Box& xbx = amrex::surroundingNodes(bx, 0);
         const Box& gxbx = amrex::grow(xbx, 1);
@@ -437,15 +409,7 @@ Castro::construct_mol_hydro_source(Real time, Real dt, MultiFab& A_update)
           // second order method
           // -----------------------------------------------------------------
 
-          // get div{U} -- we'll use this for artificial viscosity
-          div.resize(obx, 1);
-          Elixir elix_div = div.elixir();
-
-          auto div_arr = div.array();
-
-          if (do_hydro) {
-            divu(obx, q_arr, div_arr);
-          }
+          // div{U} for the artificial viscosity was computed above
 
           const Box& tbx = amrex::grow(bx, 2);
 
@@ -748,6 +712,10 @@ Castro::construct_mol_hydro_source(Real time, Real dt, MultiFab& A_update)
 
   BL_PROFILE_VAR_STOP(CA_UMDRV);
 
+  if (sdc_order != 4) {
+      record_tile_time(tile_family_hydro, ParallelDescriptor::second() - strt_time);
+  }
+
   // Flush Fortran output
 
   if (verbose)
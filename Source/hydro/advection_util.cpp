@@ -7,6 +7,7 @@
 
 #include <Castro_util.H>
 #include <advection_util.H>
+#include <flatten.H>
 
 #ifdef HYBRID_MOMENTUM
 #include <hybrid.H>
@@ -124,24 +125,25 @@ Castro::ctoprim(const Box& bx,
 #endif
 
     // Load passively advected quatities into q
-    for (int ipassive = 0; ipassive < npassive; ipassive++) {
-      int n  = upassmap(ipassive);
-      int iq = qpassmap(ipassive);
-      q_arr(i,j,k,iq) = uin(i,j,k,n) * rhoinv;
-    }
+    unroll_for<npassive>([&] (int ipassive)
+    {
+      q_arr(i,j,k,qpassmap(ipassive)) = uin(i,j,k,upassmap(ipassive)) * rhoinv;
+    });
 
     // get gamc, p, T, c, csml using q state
     eos_t eos_state;
     eos_state.T = q_arr(i,j,k,QTEMP);
     eos_state.rho = q_arr(i,j,k,QRHO);
     eos_state.e = q_arr(i,j,k,QREINT);
-    for (int n = 0; n < NumSpec; n++) {
+    unroll_for<NumSpec>([&] (int n)
+    {
       eos_state.xn[n]  = q_arr(i,j,k,QFS+n);
-    }
+    });
 #if NAUX_NET > 0
-    for (int n = 0; n < NumAux; n++) {
+    unroll_for<NumAux>([&] (int n)
+    {
       eos_state.aux[n] = q_arr(i,j,k,QFX+n);
-    }
+    });
 #endif
 
     eos(eos_input_re, eos_state);
@@ -213,151 +215,13 @@ Castro::shock(const Box& bx,
   // Woodward (1984)
   //
 
-  constexpr Real small = 1.e-10_rt;
-  constexpr Real eps = 0.33e0_rt;
-
   const auto dx = geom.CellSizeArray();
   const int coord_type = geom.Coord();
 
-  Real dxinv = 1.0_rt / dx[0];
-#if AMREX_SPACEDIM >= 2
-  Real dyinv = 1.0_rt / dx[1];
-#endif
-#if AMREX_SPACEDIM == 3
-  Real dzinv = 1.0_rt / dx[2];
-#endif
-
   amrex::ParallelFor(bx,
   [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
   {
-    Real div_u = 0.0_rt;
-
-    // construct div{U}
-    if (coord_type == 0) {
-
-      // Cartesian
-      div_u += 0.5_rt * (q_arr(i+1,j,k,QU) - q_arr(i-1,j,k,QU)) * dxinv;
-#if (AMREX_SPACEDIM >= 2)
-      div_u += 0.5_rt * (q_arr(i,j+1,k,QV) - q_arr(i,j-1,k,QV)) * dyinv;
-#endif
-#if (AMREX_SPACEDIM == 3)
-      div_u += 0.5_rt * (q_arr(i,j,k+1,QW) - q_arr(i,j,k-1,QW)) * dzinv;
-#endif
-
-#if AMREX_SPACEDIM <= 2
-   } else if (coord_type == 1) {
-
-     // r-z
-     Real rc = (i + 0.5_rt) * dx[0];
-     Real rm = (i - 1 + 0.5_rt) * dx[0];
-     Real rp = (i + 1 + 0.5_rt) * dx[0];
-
-#if (AMREX_SPACEDIM == 1)
-     div_u += 0.5_rt * (rp * q_arr(i+1,j,k,QU) - rm * q_arr(i-1,j,k,QU)) / (rc * dx[0]);
-#endif
-#if (AMREX_SPACEDIM == 2)
-     div_u += 0.5_rt * (rp * q_arr(i+1,j,k,QU) - rm * q_arr(i-1,j,k,QU)) / (rc * dx[0]) +
-              0.5_rt * (q_arr(i,j+1,k,QV) - q_arr(i,j-1,k,QV)) * dyinv;
-#endif
-#endif
-
-#if AMREX_SPACEDIM == 1
-    } else if (coord_type == 2) {
-
-      // 1-d spherical
-      Real rc = (i + 0.5_rt) * dx[0];
-      Real rm = (i - 1 + 0.5_rt) * dx[0];
-      Real rp = (i + 1 + 0.5_rt) * dx[0];
-
-      div_u += 0.5_rt * (rp * rp * q_arr(i+1,j,k,QU) - rm * rm * q_arr(i-1,j,k,QU)) / (rc * rc * dx[0]);
-#endif
-
-#ifndef AMREX_USE_GPU
-
-    } else {
-      amrex::Error("ERROR: invalid coord_type in shock");
-#endif
-    }
-
-    // find the pre- and post-shock pressures in each direction
-    Real px_pre;
-    Real px_post;
-    Real e_x;
-
-    if (q_arr(i+1,j,k,QPRES) - q_arr(i-1,j,k,QPRES) < 0.0_rt) {
-      px_pre = q_arr(i+1,j,k,QPRES);
-      px_post = q_arr(i-1,j,k,QPRES);
-    } else {
-      px_pre = q_arr(i-1,j,k,QPRES);
-      px_post = q_arr(i+1,j,k,QPRES);
-    }
-
-    // use compression to create unit vectors for the shock direction
-    e_x = std::pow(q_arr(i+1,j,k,QU) - q_arr(i-1,j,k,QU), 2);
-
-    Real py_pre;
-    Real py_post;
-    Real e_y;
-
-#if (AMREX_SPACEDIM >= 2)
-    if (q_arr(i,j+1,k,QPRES) - q_arr(i,j-1,k,QPRES) < 0.0_rt) {
-      py_pre = q_arr(i,j+1,k,QPRES);
-      py_post = q_arr(i,j-1,k,QPRES);
-    } else {
-      py_pre = q_arr(i,j-1,k,QPRES);
-      py_post = q_arr(i,j+1,k,QPRES);
-    }
-
-    e_y = std::pow(q_arr(i,j+1,k,QV) - q_arr(i,j-1,k,QV), 2);
-
-#else
-    py_pre = 0.0_rt;
-    py_post = 0.0_rt;
-
-    e_y = 0.0_rt;
-#endif
-
-    Real pz_pre;
-    Real pz_post;
-    Real e_z;
-
-#if (AMREX_SPACEDIM == 3)
-    if (q_arr(i,j,k+1,QPRES) - q_arr(i,j,k-1,QPRES) < 0.0_rt) {
-      pz_pre  = q_arr(i,j,k+1,QPRES);
-      pz_post = q_arr(i,j,k-1,QPRES);
-    } else {
-      pz_pre  = q_arr(i,j,k-1,QPRES);
-      pz_post = q_arr(i,j,k+1,QPRES);
-    }
-
-    e_z = std::pow(q_arr(i,j,k+1,QW) - q_arr(i,j,k-1,QW), 2);
-
-#else
-    pz_pre = 0.0_rt;
-    pz_post = 0.0_rt;
-
-    e_z = 0.0_rt;
-#endif
-
-    Real denom = 1.0_rt / (e_x + e_y + e_z + small);
-
-    e_x = e_x * denom;
-    e_y = e_y * denom;
-    e_z = e_z * denom;
-
-    // project the pressures onto the shock direction
-    Real p_pre  = e_x * px_pre + e_y * py_pre + e_z * pz_pre;
-    Real p_post = e_x * px_post + e_y * py_post + e_z * pz_post;
-
-    // test for compression + pressure jump to flag a shock
-    // this avoid U = 0, so e_x, ... = 0
-    Real pjump = p_pre == 0 ? 0.0_rt : eps - (p_post - p_pre) / p_pre;
-
-    if (pjump < 0.0 && div_u < 0.0_rt) {
-      shk(i,j,k) = 1.0_rt;
-    } else {
-      shk(i,j,k) = 0.0_rt;
-    }
+    shk(i,j,k) = shock_zone(i, j, k, q_arr, dx, coord_type);
   });
 
 }
@@ -370,110 +234,84 @@ Castro::divu(const Box& bx,
   // this computes the *node-centered* divergence
 
   const auto dx = geom.CellSizeArray();
-
-#if AMREX_SPACEDIM <= 2
+  const auto problo = geom.ProbLoArray();
   const int coord_type = geom.Coord();
-#endif
 
+  amrex::ParallelFor(bx,
+  [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+  {
+    div(i,j,k) = divu_zone(i, j, k, q_arr, dx, problo, coord_type);
+  });
+
+}
+
+
+void
+Castro::shock_flatten_divu(const Box& bx,
+                           Array4<Real const> const& q_arr,
+                           Array4<Real> const& flatn,
+                           Array4<Real> const& shk,
+                           Array4<Real> const& div,
+                           const int compute_div) {
+
+  // Do the flattening, shock detection and velocity divergence in one
+  // pass: they read overlapping pressure and velocity stencils of q,
+  // so this saves two sweeps over it.
+
+  const auto dx = geom.CellSizeArray();
   const auto problo = geom.ProbLoArray();
+  const int coord_type = geom.Coord();
 
-  Real dxinv = 1.0_rt / dx[0];
-#if AMREX_SPACEDIM >= 2
-  Real dyinv = 1.0_rt / dx[1];
+  const int first_order = first_order_hydro;
+  const int flatten = use_flattening;
+
+#ifdef SHOCK_VAR
+  const int do_shock = 1;
 #else
-  Real dyinv = 0.0_rt;
+  const int do_shock = hybrid_riemann;
 #endif
-#if AMREX_SPACEDIM == 3
-  Real dzinv = 1.0_rt / dx[2];
+
+#ifdef RADIATION
+  // with radiation we also flatten on the total pressure, and drop
+  // to first order where the radiation pressure dominates in a
+  // compression
+  Real flatten_pp_thresh = radiation::flatten_pp_threshold;
 #endif
 
   amrex::ParallelFor(bx,
   [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
   {
+    if (first_order == 1) {
+      flatn(i,j,k) = 0.0_rt;
 
-#if AMREX_SPACEDIM == 1
-    if (coord_type == 0) {
-      div(i,j,k) = (q_arr(i,j,k,QU) - q_arr(i-1,j,k,QU)) * dxinv;
-
-    } else if (coord_type == 1) {
-      // axisymmetric
-      if (i == 0) {
-        div(i,j,k) = 0.0_rt;
-      } else {
-        Real rl = (i - 0.5_rt) * dx[0] + problo[0];
-        Real rr = (i + 0.5_rt) * dx[0] + problo[0];
-        Real rc = (i) * dx[0] + problo[0];
-
-        div(i,j,k) = (rr * q_arr(i,j,k,QU) - rl * q_arr(i-1,j,k,QU)) * dxinv / rc;
-      }
-    } else {
-      // spherical
-      if (i == 0) {
-        div(i,j,k) = 0.0_rt;
-      } else {
-        Real rl = (i - 0.5_rt) * dx[0] + problo[0];
-        Real rr = (i + 0.5_rt) * dx[0] + problo[0];
-        Real rc = (i) * dx[0] + problo[0];
-
-        div(i,j,k) = (rr * rr * q_arr(i,j,k,QU) - rl * rl * q_arr(i-1,j,k,QU)) * dxinv / (rc * rc);
-      }
-    }
-#endif
+    } else if (flatten == 1) {
+      Real fl = flatten_zone(i, j, k, q_arr, QPRES);
 
-#if AMREX_SPACEDIM == 2
-    Real ux = 0.0_rt;
-    Real vy = 0.0_rt;
+#ifdef RADIATION
+      fl *= flatten_zone(i, j, k, q_arr, QPTOT);
 
-    if (coord_type == 0) {
-      ux = 0.5_rt * (q_arr(i,j,k,QU) - q_arr(i-1,j,k,QU) + q_arr(i,j-1,k,QU) - q_arr(i-1,j-1,k,QU)) * dxinv;
-      vy = 0.5_rt * (q_arr(i,j,k,QV) - q_arr(i,j-1,k,QV) + q_arr(i-1,j,k,QV) - q_arr(i-1,j-1,k,QV)) * dyinv;
+      if (flatten_pp_thresh > 0.0) {
+        if ( q_arr(i-1,j,k,QU) + q_arr(i,j-1,k,QV) + q_arr(i,j,k-1,QW) >
+             q_arr(i+1,j,k,QU) + q_arr(i,j+1,k,QV) + q_arr(i,j,k+1,QW) ) {
 
-    } else {
-      if (i == 0) {
-        ux = 0.0_rt;
-        vy = 0.0_rt;  // is this part correct?
-      } else {
-        Real rl = (i - 0.5_rt) * dx[0] + problo[0];
-        Real rr = (i + 0.5_rt) * dx[0] + problo[0];
-        Real rc = (i) * dx[0] + problo[0];
-
-        // These are transverse averages in the y-direction
-        Real ul = 0.5_rt * (q_arr(i-1,j,k,QU) + q_arr(i-1,j-1,k,QU));
-        Real ur = 0.5_rt * (q_arr(i,j,k,QU) + q_arr(i,j-1,k,QU));
-
-        // Take 1/r d/dr(r*u)
-        ux = (rr * ur - rl * ul) * dxinv / rc;
-
-        // These are transverse averages in the x-direction
-        Real vb = 0.5_rt * (q_arr(i,j-1,k,QV) + q_arr(i-1,j-1,k,QV));
-        Real vt = 0.5_rt * (q_arr(i,j,k,QV) + q_arr(i-1,j,k,QV));
-
-        vy = (vt - vb) * dyinv;
+          if (q_arr(i,j,k,QPRES) < flatten_pp_thresh * q_arr(i,j,k,QPTOT)) {
+            fl = 0.0_rt;
+          }
+        }
       }
-    }
-
-    div(i,j,k) = ux + vy;
 #endif
 
-#if AMREX_SPACEDIM == 3
-    Real ux = 0.25_rt * (q_arr(i,j,k,QU) - q_arr(i-1,j,k,QU) +
-                         q_arr(i,j,k-1,QU) - q_arr(i-1,j,k-1,QU) +
-                         q_arr(i,j-1,k,QU) - q_arr(i-1,j-1,k,QU) +
-                         q_arr(i,j-1,k-1,QU) - q_arr(i-1,j-1,k-1,QU)) * dxinv;
+      flatn(i,j,k) = fl;
 
-    Real vy = 0.25_rt * (q_arr(i,j,k,QV) - q_arr(i,j-1,k,QV) +
-                         q_arr(i,j,k-1,QV) - q_arr(i,j-1,k-1,QV) +
-                         q_arr(i-1,j,k,QV) - q_arr(i-1,j-1,k,QV) +
-                         q_arr(i-1,j,k-1,QV) - q_arr(i-1,j-1,k-1,QV)) * dyinv;
-
-    Real wz = 0.25_rt * (q_arr(i,j,k,QW) - q_arr(i,j,k-1,QW) +
-                         q_arr(i,j-1,k,QW) - q_arr(i,j-1,k-1,QW) +
-                         q_arr(i-1,j,k,QW) - q_arr(i-1,j,k-1,QW) +
-                         q_arr(i-1,j-1,k,QW) - q_arr(i-1,j-1,k-1,QW)) * dzinv;
+    } else {
+      flatn(i,j,k) = 1.0_rt;
+    }
 
-    div(i,j,k) = ux + vy + wz;
-#endif
+    shk(i,j,k) = do_shock == 1 ? shock_zone(i, j, k, q_arr, dx, coord_type) : 0.0_rt;
 
+    if (compute_div == 1) {
+      div(i,j,k) = divu_zone(i, j, k, q_arr, dx, problo, coord_type);
+    }
   });
 
 }
@@ -613,6 +451,72 @@ Castro::normalize_species_fluxes(const Box& bx,
 }
 
 
+void
+Castro::passive_upwind_fluxes(const Box& bx, const int idir,
+                              Array4<Real const> const& q_arr,
+                              Array4<Real const> const& flatn,
+                              Array4<Real> const& flux,
+                              const Real dt) {
+
+  // The passives only ride along with the mass flux, so rather than
+  // tracing them through the characteristic and transverse machinery
+  // we reconstruct each one in the upwind zone and advect it with the
+  // mass flux from the Riemann solve (a second-order Fromm-type
+  // upwind method with an MC limiter).
+
+  const Real dtdx = dt / geom.CellSize(idir);
+  const Real slope_fac = first_order_hydro == 1 ? 0.0_rt : 1.0_rt;
+
+  const int di = idir == 0 ? 1 : 0;
+  const int dj = idir == 1 ? 1 : 0;
+  const int dk = idir == 2 ? 1 : 0;
+
+  // The passive index is the slowest-varying one, so each component
+  // is swept contiguously.
+
+  amrex::ParallelFor(bx, npassive,
+  [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k, int ipassive)
+  {
+    const int nq = qpassmap(ipassive);
+    const int nu = upassmap(ipassive);
+
+    const Real F_rho = flux(i,j,k,URHO);
+
+    // the upwind zone
+
+    int ic = i;
+    int jc = j;
+    int kc = k;
+
+    if (F_rho >= 0.0_rt) {
+      ic -= di;
+      jc -= dj;
+      kc -= dk;
+    }
+
+    const Real X  = q_arr(ic,jc,kc,nq);
+    const Real Xm = q_arr(ic-di,jc-dj,kc-dk,nq);
+    const Real Xp = q_arr(ic+di,jc+dj,kc+dk,nq);
+
+    Real dlft = 2.0_rt * (X - Xm);
+    Real drgt = 2.0_rt * (Xp - X);
+    Real dcen = 0.25_rt * (dlft + drgt);
+    Real dlim = dlft * drgt >= 0.0_rt ? amrex::min(std::abs(dlft), std::abs(drgt)) : 0.0_rt;
+
+    Real dX = slope_fac * flatn(ic,jc,kc) * std::copysign(amrex::min(dlim, std::abs(dcen)), dcen);
+
+    // the fraction of the upwind zone that crosses the face in dt
+
+    Real sigma = amrex::min(std::abs(F_rho) * dtdx / q_arr(ic,jc,kc,QRHO), 1.0_rt);
+
+    Real X_face = F_rho >= 0.0_rt ? X + 0.5_rt * (1.0_rt - sigma) * dX
+                                  : X - 0.5_rt * (1.0_rt - sigma) * dX;
+
+    flux(i,j,k,nu) = F_rho * X_face;
+  });
+}
+
+
 void
 Castro::scale_flux(const Box& bx,
 #if AMREX_SPACEDIM == 1
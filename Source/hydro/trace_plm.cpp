@@ -76,6 +76,12 @@ Castro::trace_plm(const Box& bx, const int idir,
   Real lsmall_dens = small_dens;
   Real lsmall_pres = small_pres;
 
+  // With lightweight passives the passive interface states are only
+  // needed by the EOS calls in the Riemann solve; their fluxes are
+  // recomputed from the mass flux afterward.
+
+  const int lightweight = lightweight_passives;
+
   constexpr int NEIGN = 6;
   constexpr int IEIGN_RHO = 0;
   constexpr int IEIGN_UN = 1;
@@ -381,29 +387,35 @@ Castro::trace_plm(const Box& bx, const int idir,
 
       // get the slope
 
-      if (idir == 0) {
-        s[im2] = q_arr(i-2,j,k,n);
-        s[im1] = q_arr(i-1,j,k,n);
-        s[i0]  = q_arr(i,j,k,n);
-        s[ip1] = q_arr(i+1,j,k,n);
-        s[ip2] = q_arr(i+2,j,k,n);
+      Real dX = 0.0_rt;
 
-      } else if (idir == 1) {
-        s[im2] = q_arr(i,j-2,k,n);
-        s[im1] = q_arr(i,j-1,k,n);
-        s[i0]  = q_arr(i,j,k,n);
-        s[ip1] = q_arr(i,j+1,k,n);
-        s[ip2] = q_arr(i,j+2,k,n);
+      if (!lightweight) {
 
-      } else {
-        s[im2] = q_arr(i,j,k-2,n);
-        s[im1] = q_arr(i,j,k-1,n);
-        s[i0]  = q_arr(i,j,k,n);
-        s[ip1] = q_arr(i,j,k+1,n);
-        s[ip2] = q_arr(i,j,k+2,n);
-      }
+        if (idir == 0) {
+          s[im2] = q_arr(i-2,j,k,n);
+          s[im1] = q_arr(i-1,j,k,n);
+          s[i0]  = q_arr(i,j,k,n);
+          s[ip1] = q_arr(i+1,j,k,n);
+          s[ip2] = q_arr(i+2,j,k,n);
+
+        } else if (idir == 1) {
+          s[im2] = q_arr(i,j-2,k,n);
+          s[im1] = q_arr(i,j-1,k,n);
+          s[i0]  = q_arr(i,j,k,n);
+          s[ip1] = q_arr(i,j+1,k,n);
+          s[ip2] = q_arr(i,j+2,k,n);
+
+        } else {
+          s[im2] = q_arr(i,j,k-2,n);
+          s[im1] = q_arr(i,j,k-1,n);
+          s[i0]  = q_arr(i,j,k,n);
+          s[ip1] = q_arr(i,j,k+1,n);
+          s[ip2] = q_arr(i,j,k+2,n);
+        }
 
-      Real dX = uslope(s, flat, false, false);
+        dX = uslope(s, flat, false, false);
+
+      }
 
       // Right state
       if ((idir == 0 && i >= vlo[0]) ||
@@ -134,6 +134,14 @@ Castro::trace_ppm(const Box& bx,
   Real lsmall_dens = small_dens;
   Real lsmall_pres = small_pres;
 
+  // With lightweight passives the passives are not reconstructed:
+  // their interface states are only needed by the EOS calls in the
+  // Riemann solve, and their fluxes are recomputed from the mass flux
+  // afterward. The passives are contiguous in q.
+
+  const int lightweight = lightweight_passives;
+  const int qpass_lo = qpassmap(0);
+
   // Trace to left and right edges using upwind PPM
   amrex::ParallelFor(bx,
   [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
@@ -161,6 +169,7 @@ Castro::trace_ppm(const Box& bx,
 
     for (int n = 0; n < NQ; n++) {
       if (n == QTEMP) continue;
+      if (lightweight && n >= qpass_lo && n < qpass_lo + npassive) continue;
 
       if (idir == 0) {
         s[im2] = q_arr(i-2,j,k,n);
@@ -306,6 +315,11 @@ Castro::trace_ppm(const Box& bx,
 
       int n = qpassmap(ipassive);
 
+      if (lightweight) {
+        Im[n][1] = q_arr(i,j,k,n);
+        Ip[n][1] = q_arr(i,j,k,n);
+      }
+
       // Plus state on face i
       if ((idir == 0 && i >= vlo[0]) ||
           (idir == 1 && j >= vlo[1]) ||
@@ -103,6 +103,9 @@ Castro::actual_trans_single(const Box& bx,
     bool reset_rhoe = transverse_reset_rhoe;
     Real small_p = small_pres;
 
+    // the passive fluxes are recomputed from the mass flux afterward
+    const int lightweight = lightweight_passives;
+
 #ifdef RADIATION
     int fspace_t = Radiation::fspace_advection_type;
     int comov = Radiation::comoving;
@@ -171,6 +174,11 @@ Castro::actual_trans_single(const Box& bx,
             int n = upassmap(ipassive);
             int nqp = qpassmap(ipassive);
 
+            if (lightweight) {
+                qo_arr(i,j,k,nqp) = q_arr(i,j,k,nqp);
+                continue;
+            }
+
 #if AMREX_SPACEDIM == 2
             Real rrnew = q_arr(i,j,k,QRHO) - hdt * (area_t(ir,jr,kr) * flux_t(ir,jr,kr,URHO) -
                                                 area_t(il,jl,kl) * flux_t(il,jl,kl,URHO)) * volinv;
@@ -509,6 +517,9 @@ Castro::actual_trans_final(const Box& bx,
     bool reset_rhoe = transverse_reset_rhoe;
     Real small_p = small_pres;
 
+    // the passive fluxes are recomputed from the mass flux afterward
+    const int lightweight = lightweight_passives;
+
 #ifdef RADIATION
     int fspace_t = Radiation::fspace_advection_type;
     int comov = Radiation::comoving;
@@ -605,6 +616,11 @@ Castro::actual_trans_final(const Box& bx,
             int n = upassmap(ipassive);
             int nqp = qpassmap(ipassive);
 
+            if (lightweight) {
+                qo_arr(i,j,k,nqp) = q_arr(i,j,k,nqp);
+                continue;
+            }
+
             Real rrn = q_arr(i,j,k,QRHO);
             Real compn = rrn * q_arr(i,j,k,nqp);
             Real rrnewn = rrn - cdtdx_t1 * (flux_t1(ir_t1,jr_t1,kr_t1,URHO) -
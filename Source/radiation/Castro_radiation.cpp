@@ -35,8 +35,18 @@ Castro::final_radiation_call (MultiFab& S_new, int iteration, int ncycle)
                 MultiFab& Er_new = get_new_data(Rad_Type);
                 Er_new.copy(Er_old);    
             }
+            if (radiation->subcycle_skip_update(level, S_new, parent->dtLevel(level))) {
+                Castro::computeTemp(S_new, state[State_Type].curTime(), S_new.nGrow());
+                return;
+            }
             radiation->inelastic_scattering(level);
+            if (radiation->composite_active()) {
+                // All the levels are updated together at the end of
+                // the coarse step, in Castro::post_timestep.
+                return;
+            }
             radiation->MGFLD_implicit_update(level, iteration, ncycle);
+            radiation->subcycle_save_rates(level, S_new, parent->dtLevel(level));
         }
         else if (Radiation::SolverType == Radiation::SGFLDSolver) {
             if (! Radiation::rad_hydro_combined) {
@@ -44,7 +54,12 @@ Castro::final_radiation_call (MultiFab& S_new, int iteration, int ncycle)
                 MultiFab& Er_new = get_new_data(Rad_Type);
                 Er_new.copy(Er_old);    
             }
+            if (radiation->subcycle_skip_update(level, S_new, parent->dtLevel(level))) {
+                Castro::computeTemp(S_new, state[State_Type].curTime(), S_new.nGrow());
+                return;
+            }
             radiation->single_group_update(level, iteration, ncycle);
+            radiation->subcycle_save_rates(level, S_new, parent->dtLevel(level));
         }
         else {
             MultiFab& Er_old = get_old_data(Rad_Type);
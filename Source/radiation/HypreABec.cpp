@@ -1,5 +1,6 @@
 
 #include <AMReX_ParmParse.H>
+#include <AMReX_ParallelContext.H>
 #include <AMReX_LO_BCTYPES.H>
 
 #include <HypreABec.H>
@@ -50,7 +51,8 @@ HypreABec::HypreABec(const BoxArray& grids,
                      const DistributionMapping& dmap,
                      const Geometry& _geom,
                      int _solver_flag)
-  : geom(_geom), solver_flag(_solver_flag)
+  : geom(_geom), solver_flag(_solver_flag),
+    comm(ParallelContext::CommunicatorSub())
 {
   ParmParse pp("habec");
 
@@ -80,7 +82,7 @@ HypreABec::HypreABec(const BoxArray& grids,
   // (SMG reduces to cyclic reduction in this case, so it's an exact solve.)
   // (PFMG will not work.)
 
-  HYPRE_StructGridCreate(MPI_COMM_WORLD, 2, &hgrid);
+  HYPRE_StructGridCreate(comm, 2, &hgrid);
 
   if (geom.isAnyPeriodic()) {
     BL_ASSERT(geom.isPeriodic(0));
@@ -96,7 +98,7 @@ HypreABec::HypreABec(const BoxArray& grids,
 
 #else
 
-  HYPRE_StructGridCreate(MPI_COMM_WORLD, BL_SPACEDIM, &hgrid);
+  HYPRE_StructGridCreate(comm, BL_SPACEDIM, &hgrid);
 
   if (geom.isAnyPeriodic()) {
     int is_periodic[BL_SPACEDIM];
@@ -112,7 +114,7 @@ HypreABec::HypreABec(const BoxArray& grids,
   }
 #endif
 
-  if (ParallelDescriptor::NProcs() != 1) {
+  if (ParallelContext::NProcsSub() != 1) {
     // parallel section:
     for (int i = 0; i < grids.size(); i++) {
       if (dmap[i] == ParallelDescriptor::MyProc()) {
@@ -169,20 +171,20 @@ HypreABec::HypreABec(const BoxArray& grids,
     HYPRE_StructStencilSetElement(stencil, i, offsets[i]);
   }
 
-  HYPRE_StructMatrixCreate(MPI_COMM_WORLD, hgrid, stencil, &A);
+  HYPRE_StructMatrixCreate(comm, hgrid, stencil, &A);
   HYPRE_StructMatrixSetSymmetric(A, 1);
   HYPRE_StructMatrixSetNumGhost(A, A_num_ghost);
   HYPRE_StructMatrixInitialize(A);
 
-  HYPRE_StructMatrixCreate(MPI_COMM_WORLD, hgrid, stencil, &A0);
+  HYPRE_StructMatrixCreate(comm, hgrid, stencil, &A0);
   HYPRE_StructMatrixSetSymmetric(A0, 1);
   HYPRE_StructMatrixSetNumGhost(A0, A_num_ghost);
   HYPRE_StructMatrixInitialize(A0);
 
-  //HYPRE_StructVectorCreate(MPI_COMM_WORLD, hgrid, stencil, &b);
-  //HYPRE_StructVectorCreate(MPI_COMM_WORLD, hgrid, stencil, &x);
-  HYPRE_StructVectorCreate(MPI_COMM_WORLD, hgrid, &b);
-  HYPRE_StructVectorCreate(MPI_COMM_WORLD, hgrid, &x);
+  //HYPRE_StructVectorCreate(comm, hgrid, stencil, &b);
+  //HYPRE_StructVectorCreate(comm, hgrid, stencil, &x);
+  HYPRE_StructVectorCreate(comm, hgrid, &b);
+  HYPRE_StructVectorCreate(comm, hgrid, &x);
 
   HYPRE_StructStencilDestroy(stencil); // no longer needed
 
@@ -321,6 +323,149 @@ void HypreABec::boundaryFlux(MultiFab* Flux, MultiFab& Soln, int icomp,
     }
 }
 
+void HypreABec::boundaryACoefficients(MultiFab& abc)
+{
+  BL_PROFILE("HypreABec::boundaryACoefficients");
+
+  const BoxArray& grids = acoefs->boxArray();
+
+  const NGBndry& bd = getBndry();
+  const Box& domain = bd.getDomain();
+
+  MultiFab::Copy(abc, *acoefs, 0, 0, 1, 0);
+
+  BaseFab<GpuArray<Real, AMREX_SPACEDIM+1>> matfab;
+  for (MFIter ai(abc); ai.isValid(); ++ai) {
+    int i = ai.index();
+    const Box &reg = grids[i];
+
+    matfab.resize(reg);
+    Elixir matfab_elix = matfab.elixir();
+    auto mat = matfab.array();
+
+    amrex::ParallelFor(reg,
+    [=] AMREX_GPU_HOST_DEVICE (int ii, int jj, int kk)
+    {
+        for (int n = 0; n <= AMREX_SPACEDIM; ++n) {
+            mat(ii,jj,kk)[n] = 0.e0_rt;
+        }
+    });
+
+    // Only the boundary part of the diagonal is built here: hbmat3
+    // adds the boundary term and takes out the interior coupling
+    // across the face, which the matrix-free operator does not have
+    // there in the first place, so that is put back.
+
+    for (OrientationIter oitr; oitr; oitr++) {
+      if (reg[oitr()] != domain[oitr()]) {
+        continue;
+      }
+
+      int cdir(oitr());
+      int idim = oitr().coordDir();
+      const RadBoundCond &bct = bd.bndryConds(oitr())[i];
+      const Real      &bcl = bd.bndryLocs(oitr())[i];
+      const Mask      &msk = bd.bndryMasks(oitr(),i);
+
+      Array4<int const> tfp{};
+      int bctype = bct;
+      if (bd.mixedBndry(oitr())) {
+        const BaseFab<int> &tf = *(bd.bndryTypes(oitr())[i]);
+        tfp = tf.array();
+        bctype = -1;
+      }
+      Array4<Real const> pSPa{};
+      if (SPa != 0) {
+        pSPa = (*SPa)[ai].array();
+      }
+
+      auto b_arr = (*bcoefs[idim])[ai].const_array();
+      auto msk_arr = msk.const_array();
+
+      hbmat3(reg, oitr().isLow(), idim,
+             mat, cdir, bctype,
+             tfp, bcl, msk_arr, b_arr,
+             beta, geom.data(), flux_factor,
+             pSPa);
+
+      const Real fac = beta / (dx[idim] * dx[idim]);
+      const IntVect iv_cell = oitr().isLow() ? IntVect::TheDimensionVector(idim)
+                                             : -IntVect::TheDimensionVector(idim);
+      const IntVect iv_face = oitr().isLow() ? IntVect::TheDimensionVector(idim)
+                                             : IntVect::TheZeroVector();
+
+      amrex::ParallelFor(amrex::adjCell(reg, oitr()),
+      [=] AMREX_GPU_HOST_DEVICE (int ii, int jj, int kk)
+      {
+          if (msk_arr(ii,jj,kk) > 0) {
+              IntVect iv(AMREX_D_DECL(ii,jj,kk));
+              mat(iv + iv_cell)[AMREX_SPACEDIM] += fac * b_arr(iv + iv_face);
+          }
+      });
+    }
+
+    auto a_arr = abc.array(ai);
+    const Real alpha_ = alpha;
+
+    amrex::ParallelFor(reg,
+    [=] AMREX_GPU_HOST_DEVICE (int ii, int jj, int kk)
+    {
+        a_arr(ii,jj,kk) += mat(ii,jj,kk)[AMREX_SPACEDIM] / alpha_;
+    });
+
+    Gpu::streamSynchronize();
+  }
+}
+
+void HypreABec::boundaryRhs(MultiFab& rhs)
+{
+  BL_PROFILE("HypreABec::boundaryRhs");
+
+  const BoxArray& grids = rhs.boxArray();
+
+  const NGBndry& bd = getBndry();
+  const Box& domain = bd.getDomain();
+
+  for (MFIter ri(rhs); ri.isValid(); ++ri) {
+    int i = ri.index();
+    const Box &reg = grids[i];
+
+    for (OrientationIter oitr; oitr; oitr++) {
+      if (reg[oitr()] != domain[oitr()]) {
+        continue;
+      }
+
+      int cdir(oitr());
+      int idim = oitr().coordDir();
+      const RadBoundCond &bct = bd.bndryConds(oitr())[i];
+      const Real      &bcl = bd.bndryLocs(oitr())[i];
+      const FArrayBox &fs  = bd.bndryValues(oitr())[ri];
+      const Mask      &msk = bd.bndryMasks(oitr(),i);
+
+      Array4<int const> tfp{};
+      int bctype = bct;
+      if (bd.mixedBndry(oitr())) {
+        const BaseFab<int> &tf = *(bd.bndryTypes(oitr())[i]);
+        tfp = tf.array();
+        bctype = -1;
+      }
+
+      hbvec3(reg,
+             oitr().isLow(), idim,
+             rhs.array(ri),
+             cdir, bctype,
+             tfp,
+             bho, bcl,
+             fs.array(bdcomp),
+             msk.array(),
+             (*bcoefs[idim])[ri].array(),
+             beta, geom.data());
+    }
+  }
+
+  Gpu::streamSynchronize();
+}
+
 void HypreABec::getFaceMetric(Vector<Real>& r,
                               const Box& reg,
                               const Orientation& ori,
@@ -1005,7 +1150,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
   abstol = _abstol; // may be used to change tolerance for solve
 
   if (solver_flag == 0) {
-    HYPRE_StructSMGCreate(MPI_COMM_WORLD, &solver);
+    HYPRE_StructSMGCreate(comm, &solver);
     HYPRE_StructSMGSetMemoryUse(solver, 0);
     HYPRE_StructSMGSetMaxIter(solver, maxiter);
     HYPRE_StructSMGSetRelChange(solver, 0);
@@ -1016,7 +1161,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
     HYPRE_StructSMGSetup(solver, A, b, x);
   }
   else if (solver_flag == 1) {
-    HYPRE_StructPFMGCreate(MPI_COMM_WORLD, &solver);
+    HYPRE_StructPFMGCreate(comm, &solver);
     //HYPRE_StructPFMGSetMemoryUse(solver, 0);
     HYPRE_StructPFMGSetSkipRelax(solver, 0);
     HYPRE_StructPFMGSetMaxIter(solver, maxiter);
@@ -1031,7 +1176,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
     HYPRE_StructPFMGSetup(solver, A, b, x);
   }
   else if (solver_flag == 2) {
-    HYPRE_StructJacobiCreate(MPI_COMM_WORLD, &solver);
+    HYPRE_StructJacobiCreate(comm, &solver);
     //HYPRE_StructPFMGSetMemoryUse(solver, 0);
     //HYPRE_StructPFMGSetSkipRelax(solver, 0);
     HYPRE_StructJacobiSetMaxIter(solver, maxiter);
@@ -1043,14 +1188,14 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
     HYPRE_StructJacobiSetup(solver, A, b, x);
   }
   else if (solver_flag == 3 || solver_flag == 4) {
-    HYPRE_StructPCGCreate(MPI_COMM_WORLD, &solver);
+    HYPRE_StructPCGCreate(comm, &solver);
     HYPRE_StructPCGSetMaxIter(solver, maxiter);
     HYPRE_StructPCGSetRelChange(solver, 0);
     HYPRE_StructPCGSetTol(solver, reltol);
 
     if (solver_flag == 3) {
 // pfmg pre-conditioned cg
-      HYPRE_StructPFMGCreate(MPI_COMM_WORLD, &precond);
+      HYPRE_StructPFMGCreate(comm, &precond);
       HYPRE_StructPFMGSetMaxIter(precond, 1);
       HYPRE_StructPFMGSetTol(precond, 0.0);
       HYPRE_StructPFMGSetZeroGuess(precond);
@@ -1066,7 +1211,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
                                 precond);
     }
     else if (solver_flag == 4) {
-      HYPRE_StructSMGCreate(MPI_COMM_WORLD, &precond);
+      HYPRE_StructSMGCreate(comm, &precond);
       HYPRE_StructSMGSetMemoryUse(precond, 0);
       HYPRE_StructSMGSetMaxIter(precond, 1);
       HYPRE_StructSMGSetRelChange(precond, 0);
@@ -1084,7 +1229,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
     HYPRE_StructPCGSetup(solver, A, b, x);
   }  
   else if (solver_flag == 5 || solver_flag == 6) {
-    HYPRE_StructHybridCreate(MPI_COMM_WORLD, &solver);
+    HYPRE_StructHybridCreate(comm, &solver);
     HYPRE_StructHybridSetDSCGMaxIter(solver, maxiter);
     HYPRE_StructHybridSetPCGMaxIter(solver, maxiter);
     HYPRE_StructHybridSetTol(solver, reltol);
@@ -1096,7 +1241,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
 
     /* pfmg preconditioning */
     if (solver_flag == 5) {
-      HYPRE_StructPFMGCreate(MPI_COMM_WORLD, &precond);
+      HYPRE_StructPFMGCreate(comm, &precond);
       HYPRE_StructPFMGSetMaxIter(precond, 1);
       HYPRE_StructPFMGSetTol(precond, 0.0);
       HYPRE_StructPFMGSetZeroGuess(precond);
@@ -1112,7 +1257,7 @@ void HypreABec::setupSolver(Real _reltol, Real _abstol, int maxiter)
                                    precond);
     }
     else if (solver_flag == 6) {
-      HYPRE_StructSMGCreate(MPI_COMM_WORLD, &precond);
+      HYPRE_StructSMGCreate(comm, &precond);
       HYPRE_StructSMGSetMemoryUse(precond, 0);
       HYPRE_StructSMGSetMaxIter(precond, 1);
       HYPRE_StructSMGSetRelChange(precond, 0);
@@ -14,6 +14,40 @@
 
 using namespace amrex;
 
+namespace {
+
+// Temperature of a zone with internal energy density rhoe, using the
+// density, composition and temperature guess of the state S.
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real zone_temp_from_rhoe (int i, int j, int k, Real rhoe, Array4<Real const> const& S)
+{
+    if (rhoe <= 0.e0_rt) {
+        return small_temp;
+    }
+
+    Real rhoInv = 1.e0_rt / S(i,j,k,URHO);
+
+    eos_re_t eos_state;
+    eos_state.rho = S(i,j,k,URHO);
+    eos_state.T   = S(i,j,k,UTEMP);
+    eos_state.e   = rhoe * rhoInv;
+    for (int n = 0; n < NumSpec; ++n) {
+        eos_state.xn[n] = S(i,j,k,UFS+n) * rhoInv;
+    }
+#if NAUX_NET > 0
+    for (int n = 0; n < NumAux; ++n) {
+        eos_state.aux[n] = S(i,j,k,UFX+n) * rhoInv;
+    }
+#endif
+
+    eos(eos_input_re, eos_state);
+
+    return eos_state.T;
+}
+
+}
+
 void Radiation::check_convergence_er(Real& relative, Real& absolute, Real& err_er,
                                      const MultiFab& Er_new, const MultiFab& Er_pi, 
                                      const MultiFab& kappa_p,
@@ -302,6 +336,22 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
     dedT.mult(dedT_fac);
   }
 
+  // Opacities of zones whose rho, T and Ye are all within a relative
+  // opacity_cache_tol of those of the last evaluation are reused.
+
+  const bool use_cache = opacity_cache_tol > 0.0 && !lag_opac;
+  const Real cache_tol = opacity_cache_tol;
+
+  if (use_cache && opacity_cache[level] == nullptr) {
+      opacity_cache[level].reset(new MultiFab(S_new.boxArray(), S_new.DistributionMap(),
+                                              3 + 3 * NGROUPS, 1));
+      opacity_cache[level]->setVal(-1.0);
+  }
+
+  ReduceOps<ReduceOpSum, ReduceOpSum> reduce_op;
+  ReduceData<Long, Long> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -316,6 +366,7 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
       auto dkdT_arr = dkdT[mfi].array();
       auto jg_arr = jg[mfi].array();
       auto djdT_arr = djdT[mfi].array();
+      Array4<Real> const cache = use_cache ? opacity_cache[level]->array(mfi) : Array4<Real>{};
 
       bool use_dkdT_loc = use_dkdT;
 
@@ -328,15 +379,15 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
           xnu_loc[g] = xnu[g];
       }
 
-      amrex::ParallelFor(bx,
-      [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+      reduce_op.eval(bx, reduce_data,
+      [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
       {
           const Real fac = 0.5e0_rt;
           const Real minfrac = 1.e-8_rt;
 
           if (lag_opac) {
               dkdT_arr(i,j,k) = 0.0_rt;
-              return;
+              return {0, 0};
           }
 
           Real rho = S_new_arr(i,j,k,URHO);
@@ -344,11 +395,23 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
 
           Real Ye;
           if (NumAux > 0) {
-              Real Ye = S_new_arr(i,j,k,UFX);
+              Ye = S_new_arr(i,j,k,UFX);
           } else {
               Ye = 0.e0_rt;
           }
 
+          if (use_cache &&
+              std::abs(rho  - cache(i,j,k,0)) <= cache_tol * cache(i,j,k,0) &&
+              std::abs(temp - cache(i,j,k,1)) <= cache_tol * cache(i,j,k,1) &&
+              std::abs(Ye   - cache(i,j,k,2)) <= cache_tol * std::abs(cache(i,j,k,2))) {
+              for (int g = 0; g < NGROUPS; ++g) {
+                  kappa_p_arr(i,j,k,g) = cache(i,j,k,3+g);
+                  kappa_r_arr(i,j,k,g) = cache(i,j,k,3+NGROUPS+g);
+                  dkdT_arr(i,j,k,g) = cache(i,j,k,3+2*NGROUPS+g);
+              }
+              return {1, 1};
+          }
+
           Real dT;
           if (star_is_valid > 0) {
               dT = fac * std::abs(temp_star_arr(i,j,k) - temp_new_arr(i,j,k));
@@ -387,6 +450,19 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
                   dkdT_arr(i,j,k,g) = (kp2 - kp1) / (2.e0_rt * dT);
               }
           }
+
+          if (use_cache) {
+              cache(i,j,k,0) = rho;
+              cache(i,j,k,1) = temp;
+              cache(i,j,k,2) = Ye;
+              for (int g = 0; g < NGROUPS; ++g) {
+                  cache(i,j,k,3+g) = kappa_p_arr(i,j,k,g);
+                  cache(i,j,k,3+NGROUPS+g) = kappa_r_arr(i,j,k,g);
+                  cache(i,j,k,3+2*NGROUPS+g) = dkdT_arr(i,j,k,g);
+              }
+          }
+
+          return {0, use_cache ? 1 : 0};
       });
 
       const Box& reg = mfi.tilebox();
@@ -432,12 +508,39 @@ void Radiation::eos_opacity_emissivity(const MultiFab& S_new,
       });
   }    
 
+  ReduceTuple hv = reduce_data.value();
+  if (use_cache) {
+      opacity_cache_hits[level] += amrex::get<0>(hv);
+      opacity_cache_lookups[level] += amrex::get<1>(hv);
+  }
+
   if (ngrow == 0 && !lag_opac) {
       kappa_r.FillBoundary(geom.periodicity());
   }
 }
 
 
+void Radiation::opacity_cache_report(int level)
+{
+  if (opacity_cache_tol <= 0.0) {
+    return;
+  }
+
+  Long counts[2] = {opacity_cache_hits[level], opacity_cache_lookups[level]};
+  ParallelDescriptor::ReduceLongSum(counts, 2);
+
+  opacity_cache_hits[level] = 0;
+  opacity_cache_lookups[level] = 0;
+
+  if (verbose >= 1 && counts[1] > 0) {
+    amrex::Print() << "Opacity cache: " << counts[0] << " of " << counts[1]
+                   << " zone evaluations reused ("
+                   << 100.0 * static_cast<Real>(counts[0]) / static_cast<Real>(counts[1])
+                   << "%)" << std::endl;
+  }
+}
+
+
 void Radiation::gray_accel(MultiFab& Er_new, MultiFab& Er_pi, 
                            MultiFab& kappa_p, MultiFab& kappa_r,
                            MultiFab& etaT, MultiFab& eta1,
@@ -458,6 +561,16 @@ void Radiation::gray_accel(MultiFab& Er_new, MultiFab& Er_pi,
   else {
     solver->setHypreMulti(0.0);
   }
+
+  // The boundary values only depend on the time and the coarse level,
+  // which are fixed during the update, so they are kept from the first
+  // call and put back after the correction solve instead of being
+  // rebuilt on every outer iteration.
+
+  if (!mgbd.hasSavedBndryValues()) {
+    mgbd.saveBndryValues();
+  }
+
   mgbd.setCorrection();
 
   MultiFab Er_zero(grids, dmap, 1, 0);
@@ -502,9 +615,7 @@ void Radiation::gray_accel(MultiFab& Er_new, MultiFab& Er_pi,
   }
 
   // Extrapolate spectrum out one cell
-  for (int indx = 0; indx < nGroups; indx++) {
-    extrapolateBorders(spec, indx);
-  }
+  extrapolateBorders(spec, 0, nGroups);
   // Overwrite all extrapolated components with values from
   // neighboring fine grids where they exist:
   spec.FillBoundary(parent->Geom(level).periodicity());
@@ -696,7 +807,7 @@ void Radiation::gray_accel(MultiFab& Er_new, MultiFab& Er_pi,
   }
 
   mgbd.unsetCorrection();
-  getBndryDataMG(mgbd, Er_new, time, level);
+  mgbd.restoreBndryValues();
 
   solver->restoreHypreMulti();
 }
@@ -855,43 +966,11 @@ void Radiation::update_matter(MultiFab& rhoe_new, MultiFab& temp_new,
                 re_n(i,j,k) = re_s(i,j,k) + chg;
 
                 re_n(i,j,k) = (re_n(i,j,k) + ptc_tau * re_s(i,j,k)) / (1.e0_rt + ptc_tau);
-            });
-
-            temp_new[mfi].copy<RunOn::Device>(rhoe_new[mfi],bx);
-            Gpu::synchronize();
-
-            amrex::ParallelFor(bx,
-            [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-            {
-                // Get T from rhoe (temp_new comes in with rhoe)
 
-                if (Tp_n(i,j,k) <= 0.e0_rt)
-                {
-                    Tp_n(i,j,k) = small_temp;
-                }
-                else
-                {
-                    Real rhoInv = 1.e0_rt / S_new_arr(i,j,k,URHO);
-
-                    eos_re_t eos_state;
-                    eos_state.rho = S_new_arr(i,j,k,URHO);
-                    eos_state.T   = S_new_arr(i,j,k,UTEMP);
-                    eos_state.e   = Tp_n(i,j,k) * rhoInv;
-                    for (int n = 0; n < NumSpec; ++n) {
-                        eos_state.xn[n] = S_new_arr(i,j,k,UFS+n) * rhoInv;
-                    }
-#if NAUX_NET > 0
-                    for (int n = 0; n < NumAux; ++n) {
-                        eos_state.aux[n] = S_new_arr(i,j,k,UFX+n) * rhoInv;
-                    }
-#endif
+                // Get T from rhoe
 
-                    eos(eos_input_re, eos_state);
-
-                    Tp_n(i,j,k) = eos_state.T;
-                }
+                Tp_n(i,j,k) = zone_temp_from_rhoe(i, j, k, re_n(i,j,k), S_new_arr);
             });
-            Gpu::synchronize();
         }
         else {
 
@@ -1069,6 +1148,10 @@ void Radiation::estimate_gamrPr(const FArrayBox& state, const FArrayBox& Er,
         }
 #endif
 
+        const bool use_table = limiter_table_size > 0;
+
+        FLDTable table{limiter_table_lambda.dataPtr(), limiter_table_eddf.dataPtr(), limiter_table_size};
+
         amrex::ParallelFor(box,
         [=, limiter = limiter, comoving = Radiation::comoving, closure = Radiation::closure]
         AMREX_GPU_DEVICE (int i, int j, int k)
@@ -1419,11 +1502,11 @@ void Radiation::estimate_gamrPr(const FArrayBox& state, const FArrayBox& Er,
                 Real gE = std::sqrt(gE1 * gE1 + gE2 * gE2 + gE3 * gE3);
 
                 Real r = gE / (kappa_r_arr(i,j,k,g) * amrex::max(Er_arr(i,j,k,g), 1.e-50_rt));
-                Real lam = FLDlambda(r, limiter);
+                Real lam = use_table ? table.FLDlambda(r) : FLDlambda(r, limiter);
 
                 Real gamr;
                 if (comoving == 1) {
-                    Real f = Edd_factor(lam, limiter, closure);
+                    Real f = use_table ? table.Edd_factor(lam) : Edd_factor(lam, limiter, closure);
                     gamr = (3.0_rt - f) / 2.0_rt;
                 }
                 else {
@@ -1653,3 +1736,264 @@ void Radiation::inelastic_scattering(int level)
         castro->computeTemp(S_new, castro->state[State_Type].curTime(), S_new.nGrow());
     }
 }
+
+void Radiation::temp_from_rhoe(MultiFab& temp_new, const MultiFab& rhoe_new,
+                               const MultiFab& S_new)
+{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(rhoe_new, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+
+        auto temp = temp_new[mfi].array();
+        auto rhoe = rhoe_new[mfi].array();
+        auto state = S_new[mfi].array();
+
+        amrex::ParallelFor(bx,
+        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+        {
+            temp(i,j,k) = zone_temp_from_rhoe(i, j, k, rhoe(i,j,k), state);
+        });
+    }
+}
+
+
+void Radiation::anderson_reset(AndersonHistory& ah)
+{
+    ah.dG.clear();
+    ah.dF.clear();
+    ah.nhist = 0;
+    ah.have_prev = false;
+}
+
+
+bool Radiation::anderson_mix(AndersonHistory& ah,
+                             MultiFab& rhoe_new, MultiFab& Er_new,
+                             const MultiFab& rhoe_star, const MultiFab& Er_star,
+                             const MultiFab& rhoe_step, const MultiFab& Er_step)
+{
+    BL_PROFILE("Radiation::anderson_mix");
+
+    const BoxArray& ba = rhoe_new.boxArray();
+    const DistributionMapping& dm = rhoe_new.DistributionMap();
+    const int nc = nGroups + 1;
+
+    // The residuals are scaled so that rhoe and the radiation energy
+    // count equally in the least squares problem.  The scaling is fixed
+    // for the whole implicit update.
+
+    if (ah.weight.boxArray().empty()) {
+        ah.weight.define(ba, dm, 2, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(ah.weight, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.tilebox();
+
+            auto w = ah.weight[mfi].array();
+            auto re2 = rhoe_step[mfi].array();
+            auto Er2 = Er_step[mfi].array();
+
+            amrex::ParallelFor(bx,
+            [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+            {
+                Real Etot = 0.e0_rt;
+                for (int g = 0; g < NGROUPS; ++g) {
+                    Etot += std::abs(Er2(i,j,k,g));
+                }
+                w(i,j,k,0) = 1.e0_rt / (std::abs(re2(i,j,k)) + 1.e-50_rt);
+                w(i,j,k,1) = 1.e0_rt / (Etot + 1.e-50_rt);
+            });
+        }
+    }
+
+    // G is the output of the last iteration, F its scaled residual.
+
+    MultiFab G(ba, dm, nc, 0);
+    MultiFab F(ba, dm, nc, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(G, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+
+        auto G_arr = G[mfi].array();
+        auto F_arr = F[mfi].array();
+        auto w = ah.weight[mfi].array();
+        auto ren = rhoe_new[mfi].array();
+        auto res = rhoe_star[mfi].array();
+        auto Ern = Er_new[mfi].array();
+        auto Ers = Er_star[mfi].array();
+
+        amrex::ParallelFor(bx,
+        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+        {
+            G_arr(i,j,k,0) = ren(i,j,k);
+            F_arr(i,j,k,0) = (ren(i,j,k) - res(i,j,k)) * w(i,j,k,0);
+            for (int g = 0; g < NGROUPS; ++g) {
+                G_arr(i,j,k,g+1) = Ern(i,j,k,g);
+                F_arr(i,j,k,g+1) = (Ern(i,j,k,g) - Ers(i,j,k,g)) * w(i,j,k,1);
+            }
+        });
+    }
+
+    if (ah.have_prev) {
+        if (ah.nhist == anderson_depth) {
+            // drop the oldest differences
+            ah.dG.erase(ah.dG.begin());
+            ah.dF.erase(ah.dF.begin());
+            ah.nhist--;
+        }
+
+        ah.dG.emplace_back(ba, dm, nc, 0);
+        ah.dF.emplace_back(ba, dm, nc, 0);
+        MultiFab::LinComb(ah.dG.back(), 1.0, G, 0, -1.0, ah.G_prev, 0, 0, nc, 0);
+        MultiFab::LinComb(ah.dF.back(), 1.0, F, 0, -1.0, ah.F_prev, 0, 0, nc, 0);
+        ah.nhist++;
+    }
+    else {
+        ah.G_prev.define(ba, dm, nc, 0);
+        ah.F_prev.define(ba, dm, nc, 0);
+    }
+
+    MultiFab::Copy(ah.G_prev, G, 0, 0, nc, 0);
+    MultiFab::Copy(ah.F_prev, F, 0, 0, nc, 0);
+    ah.have_prev = true;
+
+    const int m = ah.nhist;
+
+    if (m == 0) {
+        // plain fixed point step
+        return false;
+    }
+
+    // Solve the least squares problem min |F - dF gamma| through its
+    // normal equations, with all the dot products in one reduction.
+
+    Vector<Real> dots(m * m + m, 0.0);
+    for (int a = 0; a < m; ++a) {
+        for (int b = 0; b <= a; ++b) {
+            dots[a * m + b] = MultiFab::Dot(ah.dF[a], 0, ah.dF[b], 0, nc, 0, true);
+        }
+        dots[m * m + a] = MultiFab::Dot(ah.dF[a], 0, F, 0, nc, 0, true);
+    }
+
+    ParallelDescriptor::ReduceRealSum(dots.dataPtr(), static_cast<int>(dots.size()));
+
+    Vector<Real> A(m * m), gamma(m);
+    Real diag_max = 0.0;
+    for (int a = 0; a < m; ++a) {
+        for (int b = 0; b <= a; ++b) {
+            A[a * m + b] = A[b * m + a] = dots[a * m + b];
+        }
+        gamma[a] = dots[m * m + a];
+        diag_max = amrex::max(diag_max, A[a * m + a]);
+    }
+
+    // A little regularization keeps nearly dependent differences from
+    // producing huge coefficients.
+
+    for (int a = 0; a < m; ++a) {
+        A[a * m + a] += 1.e-10_rt * diag_max;
+    }
+
+    // Gaussian elimination with partial pivoting
+
+    bool singular = (diag_max <= 0.0);
+
+    for (int col = 0; col < m && !singular; ++col) {
+        int piv = col;
+        for (int r = col + 1; r < m; ++r) {
+            if (std::abs(A[r * m + col]) > std::abs(A[piv * m + col])) {
+                piv = r;
+            }
+        }
+        if (A[piv * m + col] == 0.0) {
+            singular = true;
+            break;
+        }
+        if (piv != col) {
+            for (int c = 0; c < m; ++c) {
+                std::swap(A[col * m + c], A[piv * m + c]);
+            }
+            std::swap(gamma[col], gamma[piv]);
+        }
+        for (int r = col + 1; r < m; ++r) {
+            Real fac = A[r * m + col] / A[col * m + col];
+            for (int c = col; c < m; ++c) {
+                A[r * m + c] -= fac * A[col * m + c];
+            }
+            gamma[r] -= fac * gamma[col];
+        }
+    }
+
+    if (singular) {
+        if (verbose >= 2) {
+            amrex::Print() << "Anderson acceleration: singular least squares problem, restarting" << std::endl;
+        }
+        anderson_reset(ah);
+        return false;
+    }
+
+    for (int r = m - 1; r >= 0; --r) {
+        for (int c = r + 1; c < m; ++c) {
+            gamma[r] -= A[r * m + c] * gamma[c];
+        }
+        gamma[r] /= A[r * m + r];
+    }
+
+    if (verbose >= 2) {
+        amrex::Print() << "Anderson acceleration with " << m << " previous iterations" << std::endl;
+    }
+
+    // The new iterate is G - dG gamma.
+
+    GpuArray<Real, max_anderson_depth> gam;
+    for (int a = 0; a < max_anderson_depth; ++a) {
+        gam[a] = (a < m) ? gamma[a] : 0.0;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(G, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+
+        GpuArray<Array4<Real const>, max_anderson_depth> dG_arr;
+        for (int a = 0; a < m; ++a) {
+            dG_arr[a] = ah.dG[a].const_array(mfi);
+        }
+
+        auto ren = rhoe_new[mfi].array();
+        auto Ern = Er_new[mfi].array();
+
+        amrex::ParallelFor(bx,
+        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+        {
+            Real x[NGROUPS+1];
+
+            bool ok = true;
+            for (int n = 0; n <= NGROUPS; ++n) {
+                x[n] = (n == 0) ? ren(i,j,k) : Ern(i,j,k,n-1);
+                for (int a = 0; a < m; ++a) {
+                    x[n] -= gam[a] * dG_arr[a](i,j,k,n);
+                }
+                if ((n == 0 && x[n] <= 0.e0_rt) || x[n] < 0.e0_rt) {
+                    ok = false;
+                }
+            }
+
+            if (ok) {
+                ren(i,j,k) = x[0];
+                for (int g = 0; g < NGROUPS; ++g) {
+                    Ern(i,j,k,g) = x[g+1];
+                }
+            }
+        });
+    }
+
+    return true;
+}
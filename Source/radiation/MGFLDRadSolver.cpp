@@ -1,6 +1,7 @@
 // functions specific for MGFLDSolver (SolverType 6)
 
 #include <AMReX_LO_BCTYPES.H>
+#include <AMReX_ParallelContext.H>
 
 #include <Radiation.H>
 #include <RadSolve.H>
@@ -8,6 +9,7 @@
 #include <Castro_F.H>
 
 #include <RAD_F.H>
+#include <perf_counters.H>
 
 #include <iostream>
 #include <iomanip>
@@ -18,9 +20,28 @@
 
 using namespace amrex;
 
+namespace
+{
+    // Work data of one level of MGFLD_composite_update, named as in
+    // MGFLD_implicit_update.
+    struct CompositeLevelData
+    {
+        MultiFab Er_old, Er_pi, Er_star;
+        MultiFab rhoe_new, rhoe_old, rhoe_star;
+        MultiFab rho, temp_new, temp_star;
+        MultiFab kappa_p, kappa_r, jg, djdT, dkdT, dedT;
+        MultiFab etaT, etaTz, eta1, coupT;
+        MultiFab rhs;
+        Array<MultiFab, BL_SPACEDIM> lambda, Flux;
+        std::unique_ptr<MultiFab> flxsave;
+        MultiFab* flxcc = nullptr;
+    };
+}
+
 void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 { 
   BL_PROFILE("Radiation::MGFLD_implicit_update");
+  CASTRO_PERF_REGION(perf_mgfld_update);
   if (verbose) {
       amrex::Print() << "Radiation MGFLD implicit update, level " << level << "..." << std::endl;
   }
@@ -149,6 +170,20 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   MGRadBndry mgbd(grids,dmap, nGroups, castro->Geom());
   getBndryDataMG(mgbd, Er_new, time, level);
 
+  // boundary data distributed like the solver of this rank's group team
+  std::unique_ptr<MGRadBndry> team_bd;
+  if (group_teams > 1) {
+    IntVect ratio = (level > 0) ? parent->refRatio(level-1) : IntVect::TheUnitVector();
+    for (int t = 0; t < group_teams; ++t) {
+      std::unique_ptr<MGRadBndry> bd(new MGRadBndry(grids, group_team_dmap[level][t],
+                                                    nGroups, castro->Geom()));
+      bd->copyBndryValues(mgbd, rad_bc, ratio);
+      if (t == my_group_team) {
+        team_bd = std::move(bd);
+      }
+    }
+  }
+
   bool have_Sanchez_Pomraning = false;
   int lo_bc[3]={0}, hi_bc[3]={0};
   for (int idim=0; idim<BL_SPACEDIM; idim++) {
@@ -176,13 +211,24 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
       Flux[n].define(castro->getEdgeBoxArray(n), dmap, 1, 0);
   }
 
+  // fluxes of all the groups, as returned by the group teams
+  Array<MultiFab, BL_SPACEDIM> Flux_groups;
+  if (group_teams > 1) {
+      for (int n = 0; n < BL_SPACEDIM; n++) {
+          Flux_groups[n].define(castro->getEdgeBoxArray(n), dmap, nGroups, 0);
+      }
+  }
+
+  // The plot variables are only needed if this step ends with a plotfile.
+  const bool save_plotvar = plotvar_due(level);
+
   std::unique_ptr<MultiFab> flxsave;
   MultiFab* flxcc;
   int icomp_flux = -1;
-  if (plot_com_flux) {
+  if (save_plotvar && plot_com_flux) {
       flxcc = plotvar[level].get();
       icomp_flux = icomp_com_Fr;
-  } else if (plot_lab_Er || plot_lab_flux) {
+  } else if (save_plotvar && (plot_lab_Er || plot_lab_flux)) {
       flxsave.reset(new MultiFab(grids, dmap, nGroups*BL_SPACEDIM, 0));
       flxcc = flxsave.get();
       icomp_flux = 0;
@@ -196,6 +242,8 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   Real reltol_in = relInTol;
   Real ptc_tau = 0.0;  // not being used 
 
+  AndersonHistory anderson;
+
   // nonlinear loop for all groups
   int it = 0;
   bool conservative_update = false;
@@ -263,44 +311,64 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 
       compute_coupling(coupT, kappa_p, Er_pi, jg);
 
-      for (int igroup=0; igroup<nGroups; ++igroup) {
+      if (group_teams > 1) {
+        MGFLD_group_team_solve(level, lambda, kappa_p, kappa_r, jg, mugT,
+                               coupT, etaT, Er_step, rhoe_step, Er_star, rhoe_star,
+                               Er_new, Flux_groups, *team_bd,
+                               delta_t, it, ptc_tau,
+                               have_Sanchez_Pomraning, lo_bc, hi_bc);
 
-        set_current_group(igroup);
+        for (int igroup=0; igroup<nGroups; ++igroup) {
+          for (int n = 0; n < BL_SPACEDIM; n++) {
+            MultiFab::Copy(Flux[n], Flux_groups[n], igroup, 0, 1, 0);
+          }
+
+          solver->levelFluxReg(level, flux_in, flux_out, Flux, igroup);
+
+          if (icomp_flux >= 0)
+              solver->levelFluxFaceToCenter(level, Flux, *flxcc, icomp_flux+igroup);
+        }
+      }
+      else {
+        for (int igroup=0; igroup<nGroups; ++igroup) {
 
-        // setup and solve linear system
+          set_current_group(igroup);
 
-        // set boundary condition
-        solver->levelBndry(mgbd, igroup);
+          // setup and solve linear system
+
+          // set boundary condition
+          solver->levelBndry(mgbd, igroup);
         
-        solver->levelACoeffs(level, kappa_p, delta_t, c, igroup, ptc_tau);
+          solver->levelACoeffs(level, kappa_p, delta_t, c, igroup, ptc_tau);
 
-        int lamcomp = (limiter==0) ? 0 : igroup;
-        solver->levelBCoeffs(level, lambda, kappa_r, igroup, c, lamcomp);
+          int lamcomp = (limiter==0) ? 0 : igroup;
+          solver->levelBCoeffs(level, lambda, kappa_r, igroup, c, lamcomp);
 
-        if (have_Sanchez_Pomraning) {
-          solver->levelSPas(level, lambda, igroup, lo_bc, hi_bc);
-        }
+          if (have_Sanchez_Pomraning) {
+            solver->levelSPas(level, lambda, igroup, lo_bc, hi_bc);
+          }
 
-        { // src and rhd block
+          { // src and rhd block
                   
-          MultiFab rhs(grids,dmap,1,0);
+            MultiFab rhs(grids,dmap,1,0);
 
-          solver->levelRhs(level, rhs, jg, mugT,
-                           coupT, etaT,
-                           Er_step, rhoe_step, Er_star, rhoe_star,
-                           delta_t, igroup, it, ptc_tau);
+            solver->levelRhs(level, rhs, jg, mugT,
+                             coupT, etaT,
+                             Er_step, rhoe_step, Er_star, rhoe_star,
+                             delta_t, igroup, it, ptc_tau);
 
-          // solve Er equation and put solution in Er_new(igroup)
-          solver->levelSolve(level, Er_new, igroup, rhs, 0.01);
-        } // end src and rhs block
+            // solve Er equation and put solution in Er_new(igroup)
+            solver->levelSolve(level, Er_new, igroup, rhs, 0.01);
+          } // end src and rhs block
 
-        solver->levelFlux(level, Flux, Er_new, igroup);
-        solver->levelFluxReg(level, flux_in, flux_out, Flux, igroup);
+          solver->levelFlux(level, Flux, Er_new, igroup);
+          solver->levelFluxReg(level, flux_in, flux_out, Flux, igroup);
           
-        if (icomp_flux >= 0) 
-            solver->levelFluxFaceToCenter(level, Flux, *flxcc, icomp_flux+igroup);
+          if (icomp_flux >= 0) 
+              solver->levelFluxFaceToCenter(level, Flux, *flxcc, icomp_flux+igroup);
 
-      } // end loop over groups
+        } // end loop over groups
+      }
       
       // Check for convergence *before* acceleration step:
       check_convergence_er(relative_in, absolute_in, error_er, Er_new, Er_pi,
@@ -363,41 +431,7 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
     }
 
     // update rhoe and T
-    if (matter_update_type == 0) {
-      conservative_update = true;
-    }
-    else if (matter_update_type == 1) {
-      if (outer_ready || it >= maxiter) {
-        conservative_update = true;
-      }
-      else {
-        conservative_update = false;
-      }
-    }
-    else if (matter_update_type == 2) {
-      if (it%2 == 0) {
-        conservative_update = true;
-      }
-      else {
-        conservative_update = false;
-      }
-    }
-    else if (matter_update_type == 3) {
-      if (outer_ready || it >= maxiter) {
-        conservative_update = true;
-      }
-      else {
-        if (it%2 == 0) {
-          conservative_update = true;
-        }
-        else {
-          conservative_update = false;
-        }
-      }
-    }
-    else {
-      conservative_update = true;
-    }
+    conservative_update = use_conservative_update(it, outer_ready);
 
     update_matter(rhoe_new, temp_new, Er_new, Er_pi,
                   rhoe_star, rhoe_step,
@@ -481,6 +515,28 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
                              kappa_p, kappa_r, jg, 
                              djdT, dkdT, dedT, // output
                              level, it+1, 0);
+
+      anderson_reset(anderson);
+    }
+    else if (anderson_depth > 0) {
+      // Only the conservative updates are accelerated, since the fixed
+      // point map is different for the nonconservative ones.  The
+      // converged state is always an unmixed update_matter result.
+      if (!conservative_update) {
+        anderson_reset(anderson);
+      }
+      else if (!converged && it < maxiter &&
+               anderson_mix(anderson, rhoe_new, Er_new, rhoe_star, Er_star,
+                            rhoe_step, Er_step)) {
+
+        temp_from_rhoe(temp_new, rhoe_new, S_new);
+
+        eos_opacity_emissivity(S_new, temp_new,
+                               temp_star, // input
+                               kappa_p, kappa_r, jg, 
+                               djdT, dkdT, dedT, // output
+                               level, it+1, 0);
+      }
     }
    
   } while ( ((!converged || !inner_converged) && it<maxiter)
@@ -499,6 +555,8 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
     std::cout.precision(oldprec);
   }
 
+  opacity_cache_report(level);
+
   if (!converged) {
       amrex::Abort("Implicit Update Failed to Converge");
   }
@@ -549,19 +607,19 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
       amrex::Print() << "Delta T      Ratio = " << dTrat << std::endl;
   }
 
-  if (plot_lambda) {
+  if (save_plotvar && plot_lambda) {
       save_lambda_in_plotvar(level, lambda);
   }
 
-  if (plot_kappa_p) {
+  if (save_plotvar && plot_kappa_p) {
       MultiFab::Copy(*plotvar[level], kappa_p, 0, icomp_kp, nGroups, 0);
   }
 
-  if (plot_kappa_r) {
+  if (save_plotvar && plot_kappa_r) {
       MultiFab::Copy(*plotvar[level], kappa_r, 0, icomp_kr, nGroups, 0);
   }
 
-  if (plot_lab_Er) {
+  if (save_plotvar && plot_lab_Er) {
       save_lab_Er_in_plotvar(level, S_new, Er_new, *flxcc, icomp_flux);
   }
 
@@ -569,7 +627,7 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   //     already done when calling solver->levelFluxFaceToCenter()
   // }
 
-  if (plot_lab_flux) {
+  if (save_plotvar && plot_lab_flux) {
       save_lab_flux_in_plotvar(level, S_new, lambda, Er_new, *flxcc, icomp_flux);
   }
 
@@ -577,3 +635,691 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
       amrex::Print() << "                                     done" << std::endl;
   }
 }
+
+bool Radiation::use_conservative_update(int it, bool outer_ready) const
+{
+  if (matter_update_type == 1) {
+    return outer_ready || it >= maxiter;
+  }
+  else if (matter_update_type == 2) {
+    return it%2 == 0;
+  }
+  else if (matter_update_type == 3) {
+    return outer_ready || it >= maxiter || it%2 == 0;
+  }
+  else {
+    return true;
+  }
+}
+
+void Radiation::MGFLD_group_team_solve(int level,
+                                       const Array<MultiFab, BL_SPACEDIM>& lambda,
+                                       const MultiFab& kappa_p, const MultiFab& kappa_r,
+                                       const MultiFab& jg, const MultiFab& mugT,
+                                       const MultiFab& coupT, const MultiFab& etaT,
+                                       const MultiFab& Er_step, const MultiFab& rhoe_step,
+                                       const MultiFab& Er_star, const MultiFab& rhoe_star,
+                                       MultiFab& Er_new,
+                                       Array<MultiFab, BL_SPACEDIM>& Flux,
+                                       MGRadBndry& team_bd,
+                                       Real delta_t, int it, Real ptc_tau,
+                                       bool have_Sanchez_Pomraning, int lo_bc[], int hi_bc[])
+{
+  BL_PROFILE("Radiation::MGFLD_group_team_solve");
+
+  Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
+  const BoxArray& grids = castro->boxArray();
+  const DistributionMapping& dmap = castro->DistributionMap();
+
+  // Pack the per-group inputs group by group, so that the groups of a
+  // team are a contiguous range of components and each team gets them
+  // with a single copy.  The group independent inputs go in a second
+  // MultiFab that every team gets whole.
+
+  enum { gf_kp = 0, gf_kr, gf_jg, gf_mugT, gf_Er_step, gf_Er_star, num_gf };
+  enum { sf_coupT = 0, sf_etaT, sf_rhoe_step, sf_rhoe_star, num_sf };
+
+  MultiFab gfields(grids, dmap, num_gf * nGroups, 1);
+  for (int igroup = 0; igroup < nGroups; ++igroup) {
+    const int gc = igroup * num_gf;
+    MultiFab::Copy(gfields, kappa_p, igroup, gc + gf_kp, 1, 1);
+    MultiFab::Copy(gfields, kappa_r, igroup, gc + gf_kr, 1, 1);
+    MultiFab::Copy(gfields, jg, igroup, gc + gf_jg, 1, 0);
+    MultiFab::Copy(gfields, mugT, igroup, gc + gf_mugT, 1, 0);
+    MultiFab::Copy(gfields, Er_step, igroup, gc + gf_Er_step, 1, 0);
+    MultiFab::Copy(gfields, Er_star, igroup, gc + gf_Er_star, 1, 0);
+  }
+
+  MultiFab sfields(grids, dmap, num_sf, 0);
+  MultiFab::Copy(sfields, coupT, 0, sf_coupT, 1, 0);
+  MultiFab::Copy(sfields, etaT, 0, sf_etaT, 1, 0);
+  MultiFab::Copy(sfields, rhoe_step, 0, sf_rhoe_step, 1, 0);
+  MultiFab::Copy(sfields, rhoe_star, 0, sf_rhoe_star, 1, 0);
+
+  // Move everything to the team layouts.  The MultiFabs of every team
+  // exist on all the ranks, but only hold data on the ranks of their team.
+
+  Vector<MultiFab> gfields_team(group_teams);
+  Vector<MultiFab> sfields_team(group_teams);
+  Vector<MultiFab> Er_team(group_teams);
+  Vector<Array<MultiFab, BL_SPACEDIM> > lambda_team(group_teams);
+  Vector<Array<MultiFab, BL_SPACEDIM> > Flux_team(group_teams);
+
+  for (int t = 0; t < group_teams; ++t) {
+    const DistributionMapping& team_dmap = group_team_dmap[level][t];
+    const int g0 = group_team_lo[t];
+    const int ng = group_team_lo[t+1] - g0;
+
+    gfields_team[t].define(grids, team_dmap, num_gf * ng, 1);
+    gfields_team[t].ParallelCopy(gfields, g0 * num_gf, 0, num_gf * ng, 1, 1);
+
+    sfields_team[t].define(grids, team_dmap, num_sf, 0);
+    sfields_team[t].ParallelCopy(sfields, 0, 0, num_sf);
+
+    Er_team[t].define(grids, team_dmap, ng, 0);
+    Er_team[t].ParallelCopy(Er_new, g0, 0, ng);
+
+    for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+      const int nlam = (limiter == 0) ? 1 : ng;
+      const int lam0 = (limiter == 0) ? 0 : g0;
+      lambda_team[t][idim].define(lambda[idim].boxArray(), team_dmap, nlam, 0);
+      lambda_team[t][idim].ParallelCopy(lambda[idim], lam0, 0, nlam);
+
+      Flux_team[t][idim].define(Flux[idim].boxArray(), team_dmap, ng, 0);
+    }
+  }
+
+  // Each team solves its own groups over the whole level.
+
+  {
+    const int t = my_group_team;
+    const DistributionMapping& team_dmap = group_team_dmap[level][t];
+    const int g0 = group_team_lo[t];
+    const int ng = group_team_lo[t+1] - g0;
+
+    MultiFab& gf = gfields_team[t];
+    MultiFab& sf = sfields_team[t];
+
+    MultiFab coupT_t(sf, amrex::make_alias, sf_coupT, 1);
+    MultiFab etaT_t(sf, amrex::make_alias, sf_etaT, 1);
+    MultiFab rhoe_step_t(sf, amrex::make_alias, sf_rhoe_step, 1);
+    MultiFab rhoe_star_t(sf, amrex::make_alias, sf_rhoe_star, 1);
+
+    ParallelContext::push(group_team_comm);
+
+    RadSolve* const solver = group_team_solver[level].get();
+
+    MultiFab rhs(grids, team_dmap, 1, 0);
+
+    Array<MultiFab, BL_SPACEDIM> Flux_g;
+    for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+      Flux_g[idim].define(Flux[idim].boxArray(), team_dmap, 1, 0);
+    }
+
+    for (int n = 0; n < ng; ++n) {
+
+      const int igroup = g0 + n;
+      const int gc = n * num_gf;
+
+      set_current_group(igroup);
+
+      solver->levelBndry(team_bd, igroup);
+
+      solver->levelACoeffs(level, gf, delta_t, c, gc + gf_kp, ptc_tau);
+
+      int lamcomp = (limiter==0) ? 0 : n;
+      solver->levelBCoeffs(level, lambda_team[t], gf, gc + gf_kr, c, lamcomp);
+
+      if (have_Sanchez_Pomraning) {
+        solver->levelSPas(level, lambda_team[t], lamcomp, lo_bc, hi_bc);
+      }
+
+      MultiFab jg_t(gf, amrex::make_alias, gc + gf_jg, 1);
+      MultiFab mugT_t(gf, amrex::make_alias, gc + gf_mugT, 1);
+      MultiFab Er_step_t(gf, amrex::make_alias, gc + gf_Er_step, 1);
+      MultiFab Er_star_t(gf, amrex::make_alias, gc + gf_Er_star, 1);
+
+      solver->levelRhs(level, rhs, jg_t, mugT_t,
+                       coupT_t, etaT_t,
+                       Er_step_t, rhoe_step_t, Er_star_t, rhoe_star_t,
+                       delta_t, igroup, it, ptc_tau, 0);
+
+      solver->levelSolve(level, Er_team[t], n, rhs, 0.01);
+
+      solver->levelFlux(level, Flux_g, Er_team[t], n);
+
+      for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+        MultiFab::Copy(Flux_team[t][idim], Flux_g[idim], 0, n, 1, 0);
+      }
+    }
+
+    ParallelContext::pop();
+  }
+
+  // Bring the solutions and fluxes of all the teams back to the level.
+
+  for (int t = 0; t < group_teams; ++t) {
+    const int g0 = group_team_lo[t];
+    const int ng = group_team_lo[t+1] - g0;
+
+    Er_new.ParallelCopy(Er_team[t], 0, g0, ng);
+
+    for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+      Flux[idim].ParallelCopy(Flux_team[t][idim], 0, g0, ng);
+    }
+  }
+}
+
+void Radiation::MGFLD_composite_update(int crse_level)
+{
+  BL_PROFILE("Radiation::MGFLD_composite_update");
+  CASTRO_PERF_REGION(perf_mgfld_update);
+
+  const int fine_level = parent->finestLevel();
+  const int nlevs = fine_level - crse_level + 1;
+
+  if (verbose) {
+      amrex::Print() << "Radiation MGFLD composite implicit update, levels " << crse_level
+                     << " to " << fine_level << "..." << std::endl;
+  }
+
+  BL_ASSERT(Radiation::nGroups > 0);
+
+  for (int lev = crse_level + 1; lev <= fine_level; ++lev) {
+      if (parent->nCycle(lev) != 1) {
+          amrex::Error("radiation.composite_solve requires amr.subcycling_mode = None");
+      }
+  }
+
+  composite_solver_setup(crse_level);
+
+  RadSolve* const solver = composite_solver.get();
+
+  const Real delta_t = parent->dtLevel(crse_level);
+
+  int ngrow = 1;
+
+  Vector<Castro*> castro(nlevs);
+  Vector<MultiFab*> S_new(nlevs);
+  Vector<MultiFab*> Er_new(nlevs);
+  Vector<MultiFab*> rhs(nlevs);
+  Vector<CompositeLevelData> ld(nlevs);
+
+  const bool save_plotvar = plotvar_due(crse_level);
+
+  int icomp_flux = -1;
+  if (save_plotvar && plot_com_flux) {
+      icomp_flux = icomp_com_Fr;
+  } else if (save_plotvar && (plot_lab_Er || plot_lab_flux)) {
+      icomp_flux = 0;
+  }
+
+  for (int ilev = 0; ilev < nlevs; ++ilev) {
+    const int level = crse_level + ilev;
+    CompositeLevelData& d = ld[ilev];
+
+    castro[ilev] = dynamic_cast<Castro*>(&parent->getLevel(level));
+    const BoxArray& grids = castro[ilev]->boxArray();
+    const DistributionMapping& dmap = castro[ilev]->DistributionMap();
+
+    Real time = castro[ilev]->get_state_data(Rad_Type).curTime();
+    Real oldtime = castro[ilev]->get_state_data(Rad_Type).prevTime();
+
+    S_new[ilev] = &castro[ilev]->get_new_data(State_Type);
+    AmrLevel::FillPatch(*castro[ilev], *S_new[ilev], ngrow, time, State_Type, 0, S_new[ilev]->nComp(), 0);
+
+    if (limiter > 0) {
+      for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+          d.lambda[idim].define(castro[ilev]->getEdgeBoxArray(idim), dmap, nGroups, 0);
+      }
+
+      if (inner_update_limiter == -1) {
+        MultiFab& Er_lag = castro[ilev]->get_old_data(Rad_Type);
+        Er_lag.setBndry(-1.0);
+        Er_lag.FillBoundary(parent->Geom(level).periodicity());
+
+        MultiFab& S_lag = castro[ilev]->get_old_data(State_Type);
+        for (FillPatchIterator fpi(*castro[ilev],S_lag,ngrow,oldtime,State_Type,
+                                   0,S_lag.nComp()); fpi.isValid(); ++fpi) {
+            S_lag[fpi].copy<RunOn::Device>(fpi());
+        }
+
+        MultiFab kpr_lag(grids,dmap,nGroups,1);
+        MGFLD_compute_rosseland(kpr_lag, S_lag);
+
+        for (int igroup=0; igroup<nGroups; ++igroup) {
+          scaledGradient(level, d.lambda, kpr_lag, igroup, Er_lag, igroup, limiter, 1, igroup);
+          fluxLimiter(level, d.lambda, limiter, igroup);
+        }
+      }
+    }
+    else {
+      for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+          d.lambda[idim].define(castro[ilev]->getEdgeBoxArray(idim), dmap, 1, 0);
+          d.lambda[idim].setVal(1./3.);
+      }
+    }
+
+    // There is no deferred sync source to add to Er_new: the fluxes
+    // at the coarse-fine interfaces already match.
+
+    Er_new[ilev] = &castro[ilev]->get_new_data(Rad_Type);
+
+    d.Er_old.define(grids, dmap, Er_new[ilev]->nComp(), 0);
+    MultiFab::Copy(d.Er_old, *Er_new[ilev], 0, 0, Er_new[ilev]->nComp(), 0);
+    d.Er_pi.define(grids, dmap, nGroups, 1);
+    d.Er_star.define(grids, dmap, nGroups, 1);
+    d.Er_pi.setBndry(-1.0);
+    d.Er_star.setBndry(-1.0);
+
+    d.rhoe_new.define(grids, dmap, 1, 0);
+    d.rhoe_old.define(grids, dmap, 1, 0);
+    d.rhoe_star.define(grids, dmap, 1, 0);
+
+    d.rho.define(grids, dmap, 1, 1);
+    d.temp_new.define(grids, dmap, 1, 1);
+    d.temp_star.define(grids, dmap, 1, 0);
+
+    MultiFab::Copy(d.rho, *S_new[ilev], URHO, 0, 1, 1);
+    MultiFab::Copy(d.rhoe_new, *S_new[ilev], UEINT, 0, 1, 0);
+    MultiFab::Copy(d.rhoe_old, d.rhoe_new, 0, 0, 1, 0);
+    MultiFab::Copy(d.temp_new, *S_new[ilev], UTEMP, 0, 1, 1);
+
+    d.kappa_p.define(grids, dmap, nGroups, 1);
+    d.kappa_r.define(grids, dmap, nGroups, 1);
+    d.jg.define(grids, dmap, nGroups, 1);
+    d.djdT.define(grids, dmap, nGroups, 1);
+    d.dkdT.define(grids, dmap, nGroups, 1);
+    d.etaT.define(grids, dmap, 1, 0);
+    d.etaTz.define(grids, dmap, 1, 0);
+    d.eta1.define(grids, dmap, 1, 0);
+    d.dedT.define(grids, dmap, 1, 0);
+    d.coupT.define(grids, dmap, 1, 0);
+    d.rhs.define(grids, dmap, 1, 0);
+    rhs[ilev] = &d.rhs;
+
+    // The fluxes are only needed for the plot variables, since there
+    // are no flux registers to fill.
+
+    if (icomp_flux >= 0) {
+      for (int n = 0; n < BL_SPACEDIM; n++) {
+          d.Flux[n].define(castro[ilev]->getEdgeBoxArray(n), dmap, 1, 0);
+      }
+
+      if (plot_com_flux) {
+          d.flxcc = plotvar[level].get();
+      }
+      else {
+          d.flxsave.reset(new MultiFab(grids, dmap, nGroups*BL_SPACEDIM, 0));
+          d.flxcc = d.flxsave.get();
+      }
+    }
+
+    getBndryDataMG(*composite_bd[level], *Er_new[ilev], time, level);
+  }
+
+  bool have_Sanchez_Pomraning = false;
+  int lo_bc[3]={0}, hi_bc[3]={0};
+  for (int idim=0; idim<BL_SPACEDIM; idim++) {
+    lo_bc[idim] = rad_bc.lo(idim);
+    hi_bc[idim] = rad_bc.hi(idim);
+    if (lo_bc[idim] == LO_SANCHEZ_POMRANING || 
+        hi_bc[idim] == LO_SANCHEZ_POMRANING) {
+      have_Sanchez_Pomraning = true;
+    }
+  }
+
+  Real relative_in, absolute_in, error_er;
+  Real rel_rhoe, abs_rhoe;
+  Real rel_T, abs_T;
+  Real rel_FT, abs_FT;
+
+  Real reltol_in = relInTol;
+  Real ptc_tau = 0.0;  // not being used 
+
+  // nonlinear loop for all groups and levels; the errors are the
+  // largest over the levels
+  int it = 0;
+  bool conservative_update = false;
+  bool outer_ready = false;
+  bool converged = false;
+  bool inner_converged = false;
+  do {
+    it++;
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+      const int level = crse_level + ilev;
+      CompositeLevelData& d = ld[ilev];
+
+      if (it == 1) {
+        eos_opacity_emissivity(*S_new[ilev], d.temp_new, d.temp_star,
+                               d.kappa_p, d.kappa_r, d.jg,
+                               d.djdT, d.dkdT, d.dedT,
+                               level, it, 1);
+      }
+
+      MultiFab::Copy(d.rhoe_star, d.rhoe_new, 0, 0, 1, 0);
+      MultiFab::Copy(d.temp_star, d.temp_new, 0, 0, 1, 0);
+      MultiFab::Copy(d.Er_star, *Er_new[ilev], 0, 0, nGroups, 0);
+
+      if (limiter>0 && inner_update_limiter==0) {
+        d.Er_star.FillBoundary(parent->Geom(level).periodicity());
+
+        for (int igroup=0; igroup<nGroups; ++igroup) {
+          scaledGradient(level, d.lambda, d.kappa_r, igroup, d.Er_star, igroup, limiter, 1, igroup);
+          fluxLimiter(level, d.lambda, limiter, igroup);
+        }
+      }
+
+      // After this, djdT contains mugT.
+      compute_etat(d.etaT, d.etaTz, d.eta1, d.djdT,
+                   d.dkdT, d.dedT, d.Er_star, d.rho,
+                   delta_t, ptc_tau);
+    }
+
+    // The inner loops does not update rhoe and T
+    int innerIteration = 0;
+    inner_converged = false;
+    Real relative_in_prev = 1.e200, absolute_in_prev = 1.e200;
+    bool accel_allowed = true;
+    do {
+      innerIteration++;
+
+      for (int ilev = 0; ilev < nlevs; ++ilev) {
+        const int level = crse_level + ilev;
+        CompositeLevelData& d = ld[ilev];
+
+        MultiFab::Copy(d.Er_pi, *Er_new[ilev], 0, 0, nGroups, 0);
+
+        if (limiter>0 && inner_update_limiter>0) { 
+          if (innerIteration <= inner_update_limiter) {
+            d.Er_pi.FillBoundary(parent->Geom(level).periodicity());
+
+            for (int igroup=0; igroup<nGroups; ++igroup) {
+              scaledGradient(level, d.lambda, d.kappa_r, igroup, d.Er_pi, igroup, limiter, 1, igroup);
+              fluxLimiter(level, d.lambda, limiter, igroup);
+            }
+          }
+        }
+
+        compute_coupling(d.coupT, d.kappa_p, d.Er_pi, d.jg);
+      }
+
+      for (int igroup=0; igroup<nGroups; ++igroup) {
+
+        set_current_group(igroup);
+
+        // set up the linear system of each level, then solve them together
+
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+          const int level = crse_level + ilev;
+          CompositeLevelData& d = ld[ilev];
+
+          solver->setLevelBndry(level, *composite_bd[level], igroup);
+
+          solver->levelACoeffs(level, d.kappa_p, delta_t, c, igroup, ptc_tau);
+
+          int lamcomp = (limiter==0) ? 0 : igroup;
+          solver->levelBCoeffs(level, d.lambda, d.kappa_r, igroup, c, lamcomp);
+
+          if (have_Sanchez_Pomraning) {
+            solver->levelSPas(level, d.lambda, igroup, lo_bc, hi_bc);
+          }
+
+          solver->levelRhs(level, d.rhs, d.jg, d.djdT,
+                           d.coupT, d.etaT,
+                           d.Er_old, d.rhoe_old, d.Er_star, d.rhoe_star,
+                           delta_t, igroup, it, ptc_tau);
+        }
+
+        solver->compositeSolve(Er_new, igroup, rhs);
+
+        if (icomp_flux >= 0) {
+          for (int ilev = 0; ilev < nlevs; ++ilev) {
+            const int level = crse_level + ilev;
+            CompositeLevelData& d = ld[ilev];
+
+            solver->levelFlux(level, d.Flux, *Er_new[ilev], igroup);
+            solver->levelFluxFaceToCenter(level, d.Flux, *d.flxcc, icomp_flux+igroup);
+          }
+        }
+
+      } // end loop over groups
+
+      // Check for convergence *before* acceleration step:
+      relative_in = 0.0;
+      absolute_in = 0.0;
+      error_er = 0.0;
+      for (int ilev = 0; ilev < nlevs; ++ilev) {
+        CompositeLevelData& d = ld[ilev];
+        Real rel_lev, abs_lev, err_lev;
+        check_convergence_er(rel_lev, abs_lev, err_lev, *Er_new[ilev], d.Er_pi,
+                             d.kappa_p, d.etaTz, d.temp_new, delta_t);
+        relative_in = amrex::max(relative_in, rel_lev);
+        absolute_in = amrex::max(absolute_in, abs_lev);
+        error_er = amrex::max(error_er, err_lev);
+      }
+
+      if (verbose >= 2) {
+        int oldprec = std::cout.precision(3);
+        amrex::Print() << "Outer = " << it << ", Inner = " << innerIteration
+                       << ", inner err =  " << std::setw(8) << relative_in << " (rel),  " 
+                       << std::setw(8) << absolute_in << " (abs)" << std::endl;
+        std::cout.precision(oldprec);
+      }
+
+      if (relative_in < 1.e-15) {
+        inner_converged = true;
+      }
+      else if (innerIteration < minInIter) {
+        inner_converged = false;
+      }
+      else if ( (relative_in <= reltol_in || absolute_in <= absInTol) 
+                && error_er <= reltol ) {
+        inner_converged = true;
+      }
+
+      if (!inner_converged) {
+        Real accel_fac=1.+1.e-6;
+        if (skipAccelAllowed &&
+            relative_in>accel_fac*relative_in_prev && 
+            absolute_in>accel_fac*absolute_in_prev) {
+          accel_allowed = false;
+          if (relative_in>10.*relative_in_prev && 
+              absolute_in>10.*absolute_in_prev) {
+            for (int ilev = 0; ilev < nlevs; ++ilev) {
+              MultiFab::Copy(*Er_new[ilev], ld[ilev].Er_star, 0, 0, nGroups, 0);
+            }
+          }
+        }
+        relative_in_prev = relative_in;
+        absolute_in_prev = absolute_in;
+
+        if (accel_allowed && accelerate == 1) {
+          for (int ilev = 0; ilev < nlevs; ++ilev) {
+            CompositeLevelData& d = ld[ilev];
+            local_accel(*Er_new[ilev], d.Er_pi, d.kappa_p, d.etaT,
+                        d.djdT, delta_t, ptc_tau);
+          }
+        }
+      }
+
+    } while(!inner_converged && innerIteration < maxInIter); 
+
+    if (verbose == 1) {
+      int oldprec = std::cout.precision(3);
+      amrex::Print() << "Outer = " << it << ", Inner = " << innerIteration
+                     << ", inner tol =  " << std::setw(8) << relative_in << "  " 
+                     << std::setw(8) << absolute_in << std::endl;
+      std::cout.precision(oldprec);
+    }
+
+    // update rhoe and T
+    conservative_update = use_conservative_update(it, outer_ready);
+
+    rel_rhoe = abs_rhoe = rel_FT = abs_FT = rel_T = abs_T = 0.0;
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+      const int level = crse_level + ilev;
+      CompositeLevelData& d = ld[ilev];
+
+      update_matter(d.rhoe_new, d.temp_new, *Er_new[ilev], d.Er_pi,
+                    d.rhoe_star, d.rhoe_old,
+                    d.etaT, d.etaTz, d.eta1,
+                    d.coupT,
+                    d.kappa_p, d.jg, d.djdT,
+                    *S_new[ilev], level, delta_t, ptc_tau, it, conservative_update);
+
+      eos_opacity_emissivity(*S_new[ilev], d.temp_new, d.temp_star,
+                             d.kappa_p, d.kappa_r, d.jg,
+                             d.djdT, d.dkdT, d.dedT,
+                             level, it+1, 0);
+
+      Real r_rhoe, a_rhoe, r_FT, a_FT, r_T, a_T;
+      check_convergence_matt(d.rhoe_new, d.rhoe_star, d.rhoe_old, *Er_new[ilev],
+                             d.temp_new, d.temp_star,
+                             d.rho, d.kappa_p, d.jg, d.dedT,
+                             r_rhoe, a_rhoe, r_FT, a_FT, r_T, a_T,
+                             delta_t);
+
+      rel_rhoe = amrex::max(rel_rhoe, r_rhoe);
+      abs_rhoe = amrex::max(abs_rhoe, a_rhoe);
+      rel_FT = amrex::max(rel_FT, r_FT);
+      abs_FT = amrex::max(abs_FT, a_FT);
+      rel_T = amrex::max(rel_T, r_T);
+      abs_T = amrex::max(abs_T, a_T);
+    }
+
+    Real relative_out, absolute_out;
+
+    switch (convergence_check_type) {
+    case 1:
+      relative_out = rel_rhoe;
+      absolute_out = abs_rhoe;
+      break;
+    case 2:
+      relative_out = rel_FT;
+      absolute_out = abs_FT;
+      break;
+    case 3:
+      relative_out = rel_T;
+      absolute_out = abs_T;
+      break;
+    default:
+      relative_out = rel_T;
+      if (conservative_update) {
+        relative_out = (relative_out > rel_FT  ) ? relative_out : rel_FT;
+      }
+      absolute_out = abs_T;
+    }
+
+    if (verbose >= 2) {
+      int oldprec = std::cout.precision(4);
+      amrex::Print() << "Update Errors for      rhoe,        FT,         T" 
+                     << std::endl;
+      amrex::Print() << "       Relative = " << std::setw(9) << rel_rhoe << ", " 
+                     << std::setw(9) << rel_FT << ", " << std::setw(9) << rel_T 
+                     << std::endl;
+      amrex::Print() << "       Absolute = " << std::setw(9) << abs_rhoe << ", " 
+                     << std::setw(9) << abs_FT << ", " << std::setw(9) << abs_T 
+                     << std::endl;
+      std::cout.precision(oldprec);
+    }
+
+    if (it < miniter) {
+      converged = false;
+    }
+    else if (relative_out <= reltol || absolute_out <= abstol) { 
+      converged = true;
+    }
+    else {
+      converged = false;
+    }
+
+    if (relative_out <= reltol) {
+      outer_ready = true;
+    }
+
+    if (!converged && it > n_bisect) {
+      for (int ilev = 0; ilev < nlevs; ++ilev) {
+        const int level = crse_level + ilev;
+        CompositeLevelData& d = ld[ilev];
+
+        bisect_matter(d.rhoe_new, d.temp_new,
+                      d.rhoe_star, d.temp_star,
+                      *S_new[ilev], castro[ilev]->boxArray(), level);
+
+        eos_opacity_emissivity(*S_new[ilev], d.temp_new, d.temp_star,
+                               d.kappa_p, d.kappa_r, d.jg,
+                               d.djdT, d.dkdT, d.dedT,
+                               level, it+1, 0);
+      }
+    }
+
+  } while ( ((!converged || !inner_converged) && it<maxiter)
+            || !conservative_update);
+
+  if (verbose == 1) {
+    int oldprec = std::cout.precision(4);
+    amrex::Print() << "Update Errors for      rhoe,        FT,         T" 
+                   << std::endl;
+    amrex::Print() << "       Relative = " << std::setw(9) << rel_rhoe << ", " 
+                   << std::setw(9) << rel_FT << ", " << std::setw(9) << rel_T 
+                   << std::endl;
+    amrex::Print() << "       Absolute = " << std::setw(9) << abs_rhoe << ", " 
+                   << std::setw(9) << abs_FT << ", " << std::setw(9) << abs_T 
+                   << std::endl;
+    std::cout.precision(oldprec);
+  }
+
+  for (int ilev = 0; ilev < nlevs; ++ilev) {
+    opacity_cache_report(crse_level + ilev);
+  }
+
+  if (!converged) {
+      amrex::Abort("Implicit Update Failed to Converge");
+  }
+
+  for (int ilev = 0; ilev < nlevs; ++ilev) {
+    const int level = crse_level + ilev;
+    CompositeLevelData& d = ld[ilev];
+
+    Real derat = 0.0;
+    Real dTrat = 0.0;
+
+    // update state with new fluid energy and temperature
+    state_energy_update(*S_new[ilev], d.rhoe_new, d.temp_new, castro[ilev]->boxArray(),
+                        derat, dTrat, level);
+
+    delta_e_rat_level[level] = derat;
+    delta_T_rat_level[level] = dTrat;
+
+    if (verbose >= 2) {
+        amrex::Print() << "Level " << level << ": Delta T      Ratio = " << dTrat << std::endl;
+    }
+
+    if (save_plotvar && plot_lambda) {
+        save_lambda_in_plotvar(level, d.lambda);
+    }
+
+    if (save_plotvar && plot_kappa_p) {
+        MultiFab::Copy(*plotvar[level], d.kappa_p, 0, icomp_kp, nGroups, 0);
+    }
+
+    if (save_plotvar && plot_kappa_r) {
+        MultiFab::Copy(*plotvar[level], d.kappa_r, 0, icomp_kr, nGroups, 0);
+    }
+
+    if (save_plotvar && plot_lab_Er) {
+        save_lab_Er_in_plotvar(level, *S_new[ilev], *Er_new[ilev], *d.flxcc, icomp_flux);
+    }
+
+    if (save_plotvar && plot_lab_flux) {
+        save_lab_flux_in_plotvar(level, *S_new[ilev], d.lambda, *Er_new[ilev], *d.flxcc, icomp_flux);
+    }
+  }
+
+  if (verbose) {
+      amrex::Print() << "                                     done" << std::endl;
+  }
+}
@@ -227,9 +227,14 @@ void MGRadBndry::setBndryFluxConds(const BCRec& bc, const BC_Mode phys_bc_mode)
           if (p_bc == LO_MARSHAK   || p_bc == LO_SANCHEZ_POMRANING || 
               p_bc == LO_DIRICHLET || p_bc == LO_NEUMANN) {
             if (p_bcflag == 0) {
-              for(int igroup = 0; igroup < ngroups; igroup++) {
-                  bndry[face][bi].setVal<RunOn::Host>(value_nu[igroup], igroup);
-              }
+              // all the groups in one pass over the face
+              auto const& bnd = bndry[face][bi].array();
+              const Real* vnu = value_nu.dataPtr();
+              amrex::LoopOnCpu(bndry[face][bi].box(), ngroups,
+              [=] (int ii, int jj, int kk, int igroup) noexcept
+              {
+                  bnd(ii,jj,kk,igroup) = vnu[igroup];
+              });
             }
             else {
               FArrayBox& bnd_fab = bndry[face][bi];
@@ -265,6 +270,43 @@ void MGRadBndry::setBndryFluxConds(const BCRec& bc, const BC_Mode phys_bc_mode)
 
 // *************************************************************************
 
+void MGRadBndry::copyBndryValues(const MGRadBndry& src, const BCRec& bc, IntVect& ratio)
+{
+  BL_ASSERT(boxes() == src.boxes());
+
+  setBndryConds(bc, geom, ratio);
+
+  for (OrientationIter fi; fi; ++fi) {
+    Orientation face(fi());
+    bndry[face].copyFrom(src[face], 0, 0, ngroups);
+  }
+}
+
+// *************************************************************************
+
+void MGRadBndry::saveBndryValues()
+{
+  for (OrientationIter fi; fi; ++fi) {
+    Orientation face(fi());
+    saved_bndry[face].define(bndry[face].boxArray(), bndry[face].DistributionMap(), ngroups);
+    saved_bndry[face].copyFrom(bndry[face], 0, 0, ngroups);
+  }
+
+  saved_values = true;
+}
+
+void MGRadBndry::restoreBndryValues()
+{
+  BL_ASSERT(saved_values);
+
+  for (OrientationIter fi; fi; ++fi) {
+    Orientation face(fi());
+    bndry[face].copyFrom(saved_bndry[face], 0, 0, ngroups);
+  }
+}
+
+// *************************************************************************
+
 void MGRadBndry::setHomogValues(const BCRec& bc, IntVect& ratio)
 {
 
@@ -2,6 +2,8 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_AmrLevel.H>
 #include <AMReX_LO_BCTYPES.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
 
 #include <RadSolve.H>
 #include <Radiation.H>  // for access to static physical constants only
@@ -45,6 +47,39 @@ RadSolve::RadSolve (Amr* Parent, int level, const BoxArray& grids, const Distrib
     }
 }
 
+RadSolve::RadSolve (Amr* Parent, int crse_level, int fine_level,
+                    const Vector<MGRadBndry*>& bd)
+    : parent(Parent)
+{
+    read_params();
+
+    if (radsolve::level_solver_flag < 100 ||
+        radsolve::use_hypre_nonsymmetric_terms != 0) {
+        amrex::Error("the composite radiation solve requires radsolve.level_solver_flag >= 100"
+                     " and no nonsymmetric terms");
+    }
+
+    hm.reset(new HypreMultiABec(crse_level, fine_level, radsolve::level_solver_flag));
+
+    // Finer levels first, so that each level knows the grids above it
+    // in case it leaves the covered cells out of the Hypre grid.
+
+    for (int level = fine_level; level >= crse_level; --level) {
+        IntVect fine_ratio = (level < fine_level) ? parent->refRatio(level)
+                                                  : IntVect::TheUnitVector();
+        hm->addLevel(level, parent->Geom(level), parent->boxArray(level),
+                     parent->DistributionMap(level), fine_ratio);
+    }
+
+    // The coarse-fine interpolation stencils are built from the masks.
+
+    for (int level = crse_level; level <= fine_level; ++level) {
+        hm->setBndry(level, *bd[level - crse_level]);
+    }
+
+    hm->buildMatrixStructure();
+}
+
 void
 RadSolve::read_params ()
 {
@@ -98,6 +133,17 @@ RadSolve::read_params ()
         }
     }
 
+    if (radsolve::matrix_free) {
+        if (radsolve::level_solver_flag >= 100 ||
+            radsolve::use_hypre_nonsymmetric_terms != 0) {
+            amrex::Error("radsolve.matrix_free requires level_solver_flag < 100"
+                         " and no nonsymmetric terms");
+        }
+        if (radsolve::alpha == 0.0) {
+            amrex::Error("radsolve.matrix_free requires radsolve.alpha != 0");
+        }
+    }
+
 }
 
 void RadSolve::levelInit(int level)
@@ -136,6 +182,21 @@ void RadSolve::levelBndry(MGRadBndry& mgbd, const int comp)
   }
 }
 
+void RadSolve::setLevelBndry(int level, MGRadBndry& mgbd, const int comp)
+{
+  BL_PROFILE("RadSolve::setLevelBndry");
+
+  if (hm) {
+    hm->setBndry(level, mgbd, comp);
+  }
+  else if (hem) {
+    hem->setBndry(level, mgbd, comp);
+  }
+  else {
+    hd->setBndry(mgbd, comp);
+  }
+}
+
 void RadSolve::cellCenteredApplyMetrics(int level, MultiFab& cc)
 {
     BL_PROFILE("RadSolve::cellCenteredApplyMetrics");
@@ -256,8 +317,8 @@ void RadSolve::levelACoeffs(int level,
 void RadSolve::levelSPas(int level, Array<MultiFab, BL_SPACEDIM>& lambda, int igroup, 
                          int lo_bc[3], int hi_bc[3])
 {
-  const BoxArray& grids = parent->boxArray(level);
-  const DistributionMapping& dmap = parent->DistributionMap(level);
+  const BoxArray& grids = amrex::convert(lambda[0].boxArray(), IntVect::TheCellVector());
+  const DistributionMapping& dmap = lambda[0].DistributionMap();
   const Geometry& geom = parent->Geom(level);
   const Box& domainBox = geom.Domain();
 
@@ -572,7 +633,15 @@ void RadSolve::levelSolve(int level,
     hem->setScalars(radsolve::alpha, radsolve::beta);
   }
 
-  if (hd) {
+  if (hd && radsolve::matrix_free && level == 0) {
+    Real res = matrixFreeSolve(level, Er, igroup, rhs);
+    if (verbose >= 2 && ParallelDescriptor::IOProcessor()) {
+      int oldprec = std::cout.precision(20);
+      std::cout << "Absolute residual = " << res << std::endl;
+      std::cout.precision(oldprec);
+    }
+  }
+  else if (hd) {
     hd->setupSolver(radsolve::reltol, radsolve::abstol, radsolve::maxiter);
     hd->solve(Er, igroup, rhs, Inhomogeneous_BC);
     Real res = hd->getAbsoluteResidual();
@@ -620,6 +689,109 @@ void RadSolve::levelSolve(int level,
   }
 }
 
+Real RadSolve::matrixFreeSolve(int level, MultiFab& Er, int igroup,
+                               const MultiFab& rhs)
+{
+  BL_PROFILE("RadSolve::matrixFreeSolve");
+
+  const Geometry& geom = parent->Geom(level);
+  const BoxArray& grids = Er.boxArray();
+  const DistributionMapping& dmap = Er.DistributionMap();
+
+  // The physical boundary conditions go into the diagonal and the
+  // rhs the same way as in the Hypre matrix, so the multigrid
+  // operator itself only needs homogeneous Neumann boundaries.
+
+  MultiFab acoefs(grids, dmap, 1, 0);
+  hd->boundaryACoefficients(acoefs);
+
+  MultiFab rhs_bc(grids, dmap, 1, 0);
+  MultiFab::Copy(rhs_bc, rhs, 0, 0, 1, 0);
+  hd->boundaryRhs(rhs_bc);
+
+  MultiFab soln(grids, dmap, 1, 1);
+  soln.setVal(0.0);
+  MultiFab::Copy(soln, Er, igroup, 0, 1, 0);
+
+  // The coefficients already include the metric factors.
+
+  LPInfo info;
+  info.setMetricTerm(false);
+
+  MLABecLaplacian mlabec({geom}, {grids}, {dmap}, info);
+
+  Array<LinOpBCType, AMREX_SPACEDIM> lobc, hibc;
+  for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      if (geom.isPeriodic(idim)) {
+          lobc[idim] = LinOpBCType::Periodic;
+          hibc[idim] = LinOpBCType::Periodic;
+      }
+      else {
+          lobc[idim] = LinOpBCType::Neumann;
+          hibc[idim] = LinOpBCType::Neumann;
+      }
+  }
+  mlabec.setDomainBC(lobc, hibc);
+  mlabec.setLevelBC(0, nullptr);
+
+  mlabec.setScalars(radsolve::alpha, radsolve::beta);
+  mlabec.setACoeffs(0, acoefs);
+
+  Array<MultiFab const*, AMREX_SPACEDIM> bcoefs;
+  for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      bcoefs[idim] = &hd->bCoefficients(idim);
+  }
+  mlabec.setBCoeffs(0, bcoefs);
+
+  MLMG mlmg(mlabec);
+  mlmg.setMaxIter(radsolve::maxiter);
+  mlmg.setVerbose(radsolve::verbose - 1);
+
+  Real res = mlmg.solve({&soln}, {&rhs_bc}, radsolve::reltol, radsolve::abstol);
+
+  MultiFab::Copy(Er, soln, 0, igroup, 1, 0);
+
+  return res;
+}
+
+void RadSolve::compositeSolve(const Vector<MultiFab*>& Er, int igroup,
+                              const Vector<MultiFab*>& rhs)
+{
+  BL_PROFILE("RadSolve::compositeSolve");
+
+  BL_ASSERT(hm);
+
+  const int crse_level = hm->crseLevel();
+  const int fine_level = hm->fineLevel();
+
+  hm->setScalars(radsolve::alpha, radsolve::beta);
+
+  hm->loadMatrix();
+  hm->finalizeMatrix();
+
+  for (int level = crse_level; level <= fine_level; ++level) {
+    hm->loadLevelVectors(level, *Er[level - crse_level], igroup,
+                         *rhs[level - crse_level], Inhomogeneous_BC);
+  }
+  hm->finalizeVectors();
+
+  hm->setupSolver(radsolve::reltol, radsolve::abstol, radsolve::maxiter);
+  hm->solve();
+
+  for (int level = crse_level; level <= fine_level; ++level) {
+    hm->getSolution(level, *Er[level - crse_level], igroup);
+  }
+
+  Real res = hm->getAbsoluteResidual();
+  if (verbose >= 2 && ParallelDescriptor::IOProcessor()) {
+    int oldprec = std::cout.precision(20);
+    std::cout << "Absolute residual = " << res << std::endl;
+    std::cout.precision(oldprec);
+  }
+
+  hm->clearSolver();
+}
+
 void RadSolve::levelFluxFaceToCenter(int level, const Array<MultiFab, BL_SPACEDIM>& Flux,
                                      MultiFab& flx, int iflx)
 {
@@ -659,8 +831,8 @@ void RadSolve::levelFlux(int level,
                          MultiFab& Er, int igroup)
 {
   BL_PROFILE("RadSolve::levelFlux");
-  const BoxArray& grids = parent->boxArray(level);
-  const DistributionMapping& dmap = parent->DistributionMap(level);
+  const BoxArray& grids = Er.boxArray();
+  const DistributionMapping& dmap = Er.DistributionMap();
 
   // grow a larger MultiFab to hold Er so we can difference across faces
   MultiFab Erborder(grids, dmap, 1, 1);
@@ -948,8 +1120,8 @@ void RadSolve::levelACoeffs(int level, MultiFab& kpp,
                             Real delta_t, Real c, int igroup, Real ptc_tau)
 {
   BL_PROFILE("RadSolve::levelACoeffs (MGFLD)");
-  const BoxArray& grids = parent->boxArray(level);
-  const DistributionMapping& dmap = parent->DistributionMap(level);
+  const BoxArray& grids = kpp.boxArray();
+  const DistributionMapping& dmap = kpp.DistributionMap();
   const auto geomdata = parent->Geom(level).data();
 
   // allocate space for ABecLaplacian acoeffs, fill with values
@@ -1000,7 +1172,8 @@ void RadSolve::levelRhs(int level, MultiFab& rhs, const MultiFab& jg,
                         const MultiFab& etaT,
                         const MultiFab& Er_step, const MultiFab& rhoe_step,
                         const MultiFab& Er_star, const MultiFab& rhoe_star,
-                        Real delta_t, int igroup, int it, Real ptc_tau)
+                        Real delta_t, int igroup, int it, Real ptc_tau,
+                        int icomp)
 {
   BL_PROFILE("RadSolve::levelRhs (MGFLD version)");
   Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
@@ -1010,6 +1183,8 @@ void RadSolve::levelRhs(int level, MultiFab& rhs, const MultiFab& jg,
 
   const Real dt1 = 1.0_rt / delta_t;
 
+  const int n = (icomp < 0) ? igroup : icomp;
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -1030,11 +1205,11 @@ void RadSolve::levelRhs(int level, MultiFab& rhs, const MultiFab& jg,
       amrex::ParallelFor(bx,
       [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
       {
-          Real Hg = mugT_arr(i,j,k,igroup) * etaT_arr(i,j,k);
+          Real Hg = mugT_arr(i,j,k,n) * etaT_arr(i,j,k);
 
-          rhs_arr(i,j,k) = C::c_light * (jg_arr(i,j,k,igroup) + Hg * coupT_arr(i,j,k))
-                           + dt1 * (Er_step_arr(i,j,k,igroup) - Hg * (rhoe_star_arr(i,j,k) - rhoe_step_arr(i,j,k))
-                                    + ptc_tau * Er_star_arr(i,j,k,igroup));
+          rhs_arr(i,j,k) = C::c_light * (jg_arr(i,j,k,n) + Hg * coupT_arr(i,j,k))
+                           + dt1 * (Er_step_arr(i,j,k,n) - Hg * (rhoe_star_arr(i,j,k) - rhoe_step_arr(i,j,k))
+                                    + ptc_tau * Er_star_arr(i,j,k,n));
 
           Real r, s;
           cell_center_metric(i, j, k, geomdata, r, s);
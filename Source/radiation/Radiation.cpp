@@ -1,9 +1,11 @@
 
 #include <AMReX_LO_BCTYPES.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_ParallelContext.H>
 #include <Radiation.H>
 #include <RadSolve.H>
 #include <rad_util.H>
+#include <filter.H>
 
 #include <Castro_F.H>
 
@@ -56,6 +58,7 @@ int Radiation::filter_lambda_S = 0;
 int Radiation::filter_prim_int = 0;
 int Radiation::filter_prim_T = 4;
 int Radiation::filter_prim_S = 0;
+int Radiation::filter_prim_builtin = 0;
 int Radiation::limiter = -1;
 int Radiation::closure = -1;
 
@@ -147,6 +150,7 @@ void Radiation::read_static_params()
   pp.query("filter_prim_T", filter_prim_T);
   filter_prim_S = filter_prim_T - 1;
   pp.query("filter_prim_S", filter_prim_S);
+  pp.query("filter_prim_builtin", filter_prim_builtin);
   if (filter_prim_T > 4) {
     amrex::Error("filter_prim_T > 4");
   }
@@ -369,6 +373,79 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
   inner_update_limiter = 0;
   pp.query("inner_update_limiter", inner_update_limiter);
 
+  limiter_table_size = 0;
+  pp.query("limiter_table_size", limiter_table_size);
+
+  group_teams = 1;
+  pp.query("group_teams", group_teams);
+
+  anderson_depth = 0;
+  pp.query("anderson_depth", anderson_depth);
+  if (anderson_depth < 0 || anderson_depth > max_anderson_depth) {
+    amrex::Error("radiation.anderson_depth must be between 0 and 10");
+  }
+
+  subcycle_max = 1;
+  pp.query("subcycle_max", subcycle_max);
+  if (subcycle_max < 1) {
+    amrex::Error("radiation.subcycle_max must be at least 1");
+  }
+  if (subcycle_max > 1 && SolverType != SGFLDSolver && SolverType != MGFLDSolver) {
+    amrex::Error("radiation.subcycle_max > 1 is only supported by the SGFLD and MGFLD solvers");
+  }
+
+  subcycle_tol = 1.e-3;
+  pp.query("subcycle_tol", subcycle_tol);
+
+  opacity_cache_tol = 0.0;
+  pp.query("opacity_cache_tol", opacity_cache_tol);
+  if (opacity_cache_tol > 0.0 && SolverType != MGFLDSolver) {
+    amrex::Error("radiation.opacity_cache_tol > 0 is only supported by the MGFLD solver");
+  }
+
+  composite_solve = 0;
+  pp.query("composite_solve", composite_solve);
+  if (composite_solve) {
+    if (SolverType != MGFLDSolver) {
+      amrex::Error("radiation.composite_solve is only supported by the MGFLD solver");
+    }
+    if (group_teams > 1 || anderson_depth > 0) {
+      amrex::Error("radiation.composite_solve cannot be combined with radiation.group_teams > 1"
+                   " or radiation.anderson_depth > 0");
+    }
+    // The gray acceleration solves a level system of its own, so the
+    // composite update uses the local acceleration instead.
+    if (accelerate == 2) {
+      accelerate = 1;
+      amrex::Print() << "radiation.composite_solve: using accelerate = 1" << std::endl;
+    }
+  }
+
+  // The plot variables are only saved on the steps that end with a
+  // plotfile, predicted from the same parameters Amr uses.  Plotfiles
+  // by amr.plot_log_per are not predicted, so with it they are saved
+  // on every step.
+
+  {
+    ParmParse ppa("amr");
+
+    plot_int_amr = -1;
+    ppa.query("plot_int", plot_int_amr);
+    plot_per_amr = -1.0;
+    ppa.query("plot_per", plot_per_amr);
+
+    Real plot_log_per = -1.0;
+    ppa.query("plot_log_per", plot_log_per);
+    plotvar_every_step = plot_log_per > 0.0;
+
+    ParmParse ppm;
+
+    max_step_amr = -1;
+    ppm.query("max_step", max_step_amr);
+    stop_time_amr = -1.0;
+    ppm.query("stop_time", stop_time_amr);
+  }
+
   update_opacity    = 1000;
 
   if (SolverType == SGFLDSolver || SolverType == MGFLDSolver) {
@@ -450,6 +527,10 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
   Real foo=0.0;
   FORT_KAVG(foo, foo, foo, surface_average);
 
+  if (limiter_table_size > 0) {
+    init_limiter_table();
+  }
+
   if (verbose > 0 && ParallelDescriptor::IOProcessor()) {
     std::cout << "Creating Radiation object" << std::endl;
   }
@@ -470,6 +551,13 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
     std::cout << "limiter  = " << limiter << std::endl;
     std::cout << "closure  = " << closure << std::endl;
     std::cout << "update_limiter   = " << update_limiter << std::endl;
+    std::cout << "limiter_table_size = " << limiter_table_size << std::endl;
+    std::cout << "group_teams = " << group_teams << std::endl;
+    std::cout << "anderson_depth = " << anderson_depth << std::endl;
+    std::cout << "subcycle_max = " << subcycle_max << std::endl;
+    std::cout << "subcycle_tol = " << subcycle_tol << std::endl;
+    std::cout << "opacity_cache_tol = " << opacity_cache_tol << std::endl;
+    std::cout << "composite_solve = " << composite_solve << std::endl;
     std::cout << "update_planck    = " << update_planck << std::endl;
     std::cout << "update_rosseland = " << update_rosseland << std::endl;
     std::cout << "delta_temp = " << dT << std::endl;
@@ -546,6 +634,52 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
   delta_e_rat_level.resize(levels, 0.0);
   delta_T_rat_level.resize(levels, 0.0);
 
+  subcycle_rate.resize(levels);
+  subcycle_ref.resize(levels);
+  subcycle_valid.resize(levels, 0);
+  subcycle_skipped.resize(levels, 0);
+
+  opacity_cache.resize(levels);
+  opacity_cache_hits.resize(levels, 0);
+  opacity_cache_lookups.resize(levels, 0);
+
+  // Split the ranks into the group teams.  Each team is a contiguous
+  // block of ranks and gets a contiguous, nearly equal, block of groups.
+
+  my_group_team = 0;
+  group_team_comm = ParallelDescriptor::Communicator();
+
+  if (group_teams < 1) {
+    amrex::Error("radiation.group_teams must be at least 1");
+  }
+
+  if (group_teams > 1) {
+    if (SolverType != MGFLDSolver) {
+      amrex::Error("radiation.group_teams > 1 is only supported by the MGFLD solver");
+    }
+    if (group_teams > nGroups) {
+      amrex::Error("radiation.group_teams cannot be larger than the number of groups");
+    }
+    if (ParallelDescriptor::NProcs() % group_teams != 0) {
+      amrex::Error("the number of MPI ranks must be a multiple of radiation.group_teams");
+    }
+
+    my_group_team = ParallelDescriptor::MyProc() / (ParallelDescriptor::NProcs() / group_teams);
+
+#ifdef AMREX_USE_MPI
+    MPI_Comm_split(ParallelDescriptor::Communicator(), my_group_team,
+                   ParallelDescriptor::MyProc(), &group_team_comm);
+#endif
+  }
+
+  group_team_lo.resize(group_teams + 1);
+  for (int t = 0; t <= group_teams; ++t) {
+    group_team_lo[t] = (t * nGroups) / group_teams;
+  }
+
+  group_team_dmap.resize(levels);
+  group_team_solver.resize(levels);
+
   pp.query("pure_hydro", pure_hydro);
 
   if (pure_hydro || limiter == 0) {
@@ -587,6 +721,44 @@ void Radiation::regrid(int level, const BoxArray& grids, const DistributionMappi
       plotvar[level]->setVal(0.0);
   }
 
+  // The subcycling rates are remeasured on the new grids.
+
+  subcycle_rate[level].reset();
+  subcycle_ref[level].reset();
+  subcycle_valid[level] = 0;
+
+  opacity_cache[level].reset();
+
+  if (group_teams > 1) {
+
+    // Every rank keeps the layouts of all the teams, since moving data
+    // between the level and a team involves all the ranks.  The grids
+    // are distributed over the ranks of each team the same way.
+
+    const int team_size = ParallelDescriptor::NProcs() / group_teams;
+    const DistributionMapping team_local(grids, team_size);
+
+    group_team_dmap[level].resize(group_teams);
+    for (int t = 0; t < group_teams; ++t) {
+      Vector<int> pmap = team_local.ProcessorMap();
+      for (auto& p : pmap) {
+        p += t * team_size;
+      }
+      group_team_dmap[level][t] = DistributionMapping(std::move(pmap));
+    }
+
+    // The Hypre objects of the team solver live on the team communicator.
+
+    ParallelContext::push(group_team_comm);
+    group_team_solver[level].reset(new RadSolve(parent, level, grids,
+                                                group_team_dmap[level][my_group_team]));
+    ParallelContext::pop();
+
+    if (radsolve::level_solver_flag >= 100) {
+      amrex::Error("radiation.group_teams > 1 requires radsolve.level_solver_flag < 100");
+    }
+  }
+
   // This array will not be used on the finest level.  I create it here,
   // though, in case a finer level is created before this level is next
   // regridded:
@@ -614,6 +786,15 @@ void Radiation::close(int level)
 
     plotvar[level].reset();
 
+    group_team_dmap[level].clear();
+    group_team_solver[level].reset();
+
+    subcycle_rate[level].reset();
+    subcycle_ref[level].reset();
+    subcycle_valid[level] = 0;
+
+    opacity_cache[level].reset();
+
     if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
       std::cout << "                                       done" << std::endl;
     }
@@ -1190,7 +1371,7 @@ void Radiation::state_update(MultiFab& state, MultiFab& frhoes)
 }
 
 
-void Radiation::extrapolateBorders(MultiFab& f, int indx)
+void Radiation::extrapolateBorders(MultiFab& f, int indx, int ncomp)
 {
   BL_PROFILE("Radiation::extrapolateBorders");
 
@@ -1204,8 +1385,10 @@ void Radiation::extrapolateBorders(MultiFab& f, int indx)
 
     const Box& reg  = f.box(i);
 
-    bextrp(BL_TO_FORTRAN_N(f[mfi],indx),
-           ARLIM(reg.loVect()), ARLIM(reg.hiVect()));
+    for (int n = indx; n < indx + ncomp; n++) {
+      bextrp(BL_TO_FORTRAN_N(f[mfi],n),
+             ARLIM(reg.loVect()), ARLIM(reg.hiVect()));
+    }
   }
 }
 
@@ -2441,6 +2624,13 @@ void Radiation::fluxLimiter(int level,
 {
     BL_PROFILE("Radiation:fluxLimiter");
 
+    // The table is only built for the runtime limiter, so fall back
+    // to the direct evaluation if we were asked for a different one.
+
+    const bool use_table = limiter_table_size > 0 && limiter == Radiation::limiter;
+
+    FLDTable table{limiter_table_lambda.dataPtr(), limiter_table_eddf.dataPtr(), limiter_table_size};
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -2450,15 +2640,79 @@ void Radiation::fluxLimiter(int level,
 
             auto lambda_arr = lambda[idim][mfi].array(lamcomp);
 
-            amrex::ParallelFor(bx,
-            [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
-            {
-                lambda_arr(i,j,k) = FLDlambda(lambda_arr(i,j,k), limiter);
-            });
+            if (use_table) {
+                amrex::ParallelFor(bx,
+                [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+                {
+                    lambda_arr(i,j,k) = table.FLDlambda(lambda_arr(i,j,k));
+                });
+            }
+            else {
+                amrex::ParallelFor(bx,
+                [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+                {
+                    lambda_arr(i,j,k) = FLDlambda(lambda_arr(i,j,k), limiter);
+                });
+            }
         }
     }
 }
 
+void Radiation::init_limiter_table()
+{
+    BL_PROFILE("Radiation::init_limiter_table()");
+
+    const int n = limiter_table_size;
+
+    limiter_table_lambda.resize(n + 1);
+    limiter_table_eddf.resize(n + 1);
+
+    // The flux limiter is tabulated in x = R / (1 + R); at x = 1
+    // (R -> infinity) all of the limiters go to zero.
+
+    for (int i = 0; i < n; ++i) {
+        Real x = static_cast<Real>(i) / n;
+        limiter_table_lambda[i] = FLDlambda(x / (1.0_rt - x), limiter);
+    }
+    limiter_table_lambda[n] = (limiter == 0) ? 1.0_rt / 3.0_rt : 0.0_rt;
+
+    for (int i = 0; i <= n; ++i) {
+        Real lam = static_cast<Real>(i) / (3.0_rt * n);
+        limiter_table_eddf[i] = Edd_factor(lam, limiter, closure);
+    }
+
+    // Measure the interpolation error at the quarter points of each
+    // interval.  The error of linear interpolation is largest where
+    // the functions have large curvature (for the square-root based
+    // limiters and closures, near the ends of the tables), so this
+    // gives the user a direct measure of whether the table is fine enough.
+
+    FLDTable table{limiter_table_lambda.dataPtr(), limiter_table_eddf.dataPtr(), n};
+
+    limiter_table_lambda_err = 0.0_rt;
+    limiter_table_eddf_err = 0.0_rt;
+
+    for (int i = 0; i < n; ++i) {
+        for (int m = 1; m <= 3; ++m) {
+            Real x = (static_cast<Real>(i) + 0.25_rt * m) / n;
+            Real r = x / (1.0_rt - x);
+            limiter_table_lambda_err = std::max(limiter_table_lambda_err,
+                                                std::abs(table.FLDlambda(r) - FLDlambda(r, limiter)));
+
+            Real lam = (static_cast<Real>(i) + 0.25_rt * m) / (3.0_rt * n);
+            limiter_table_eddf_err = std::max(limiter_table_eddf_err,
+                                              std::abs(table.Edd_factor(lam) - Edd_factor(lam, limiter, closure)));
+        }
+    }
+
+    if (verbose >= 1 && ParallelDescriptor::IOProcessor()) {
+        std::cout << "Flux limiter table: " << n << " intervals, max interpolation error = "
+                  << limiter_table_lambda_err << std::endl;
+        std::cout << "Eddington factor table: " << n << " intervals, max interpolation error = "
+                  << limiter_table_eddf_err << std::endl;
+    }
+}
+
 void Radiation::get_rosseland_v_dcf(MultiFab& kappa_r, MultiFab& v, MultiFab& dcf,
                                     Real delta_t, Real c,
                                     AmrLevel* castro, int igroup)
@@ -2643,6 +2897,8 @@ void Radiation::set_current_group(int igroup)
 
 void Radiation::filter_prim(int level, MultiFab& State)
 {
+  BL_PROFILE("Radiation::filter_prim");
+
   Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
   const BoxArray& grids = castro->boxArray();
   const DistributionMapping& dmap = castro->DistributionMap();
@@ -2657,6 +2913,132 @@ void Radiation::filter_prim(int level, MultiFab& State)
   int ncomp = State.nComp();
   Real time = castro->get_state_data(Rad_Type).curTime();
 
+  // State has just been through computeTemp, so this one fill gives
+  // both the stencils and the temperatures and compositions the
+  // filtered cells are made consistent with.
+
+  FillPatchIterator fpi(*castro,State,ngrow,time,State_Type,0,ncomp);
+  MultiFab& S_fp = fpi.get_mf();
+
+  if (filter_prim_builtin) {
+
+    // The filter is separable, so it is done one direction at a time
+    // on each tile: in x on the tile grown in the other directions,
+    // then in y, then in z.  That is 2T+1 points per direction instead
+    // of (2T+1)^dim.  All the filtered components go through each pass
+    // together.
+
+    constexpr int nfilt = 5;
+    const GpuArray<int, nfilt> fcomp = {URHO, UMX, UMY, UMZ, UTEMP};
+
+    const int T = filter_prim_T;
+    const auto w = filter_weights(filter_prim_T, filter_prim_S);
+    const auto wb = filter_boundary_weights(filter_prim_T);
+
+    // Cells next to a physical domain face use the one-sided stencils,
+    // as in ca_compute_lamborder; periodic faces are moved out of reach.
+
+    GpuArray<int, AMREX_SPACEDIM> flo, fhi;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+      flo[d] = geom.isPeriodic(d) ? domain_lo[d] - T : domain_lo[d];
+      fhi[d] = geom.isPeriodic(d) ? domain_hi[d] + T : domain_hi[d];
+    }
+
+    const Real lsmall_dens = small_dens;
+    const Real lsmall_temp = small_temp;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      FArrayBox q[AMREX_SPACEDIM];
+
+      for (MFIter mfi(State, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+      {
+        const Box& bx = mfi.tilebox();
+
+        auto sfp = S_fp.const_array(mfi);
+        auto snew = State.array(mfi);
+
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+          Box qbx(bx);
+          for (int d = dir + 1; d < AMREX_SPACEDIM; ++d) {
+            qbx.grow(d, T);
+          }
+
+          q[dir].resize(qbx, nfilt, The_Async_Arena());
+          auto qd = q[dir].array();
+
+          const int dlo = flo[dir];
+          const int dhi = fhi[dir];
+
+          if (dir == 0) {
+            amrex::ParallelFor(qbx, nfilt,
+            [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k, int n)
+            {
+              qd(i,j,k,n) = filter_1d(i, j, k, fcomp[n], dir, T, w, wb, dlo, dhi, sfp);
+            });
+          }
+          else {
+            auto qp = q[dir-1].const_array();
+
+            amrex::ParallelFor(qbx, nfilt,
+            [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k, int n)
+            {
+              qd(i,j,k,n) = filter_1d(i, j, k, n, dir, T, w, wb, dlo, dhi, qp);
+            });
+          }
+        }
+
+        auto qf = q[AMREX_SPACEDIM-1].const_array();
+
+        // Keep the mass fractions and recompute the energies from the
+        // filtered density and temperature.
+
+        amrex::ParallelFor(bx,
+        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+        {
+          const Real rho = amrex::max(qf(i,j,k,0), lsmall_dens);
+          const Real temp = amrex::max(qf(i,j,k,4), lsmall_temp);
+          const Real rho_old_inv = 1.0_rt / sfp(i,j,k,URHO);
+
+          eos_re_t eos_state;
+          eos_state.rho = rho;
+          eos_state.T   = temp;
+          for (int n = 0; n < NumSpec; ++n) {
+            eos_state.xn[n] = sfp(i,j,k,UFS+n) * rho_old_inv;
+          }
+#if NAUX_NET > 0
+          for (int n = 0; n < NumAux; ++n) {
+            eos_state.aux[n] = sfp(i,j,k,UFX+n) * rho_old_inv;
+          }
+#endif
+
+          eos(eos_input_rt, eos_state);
+
+          snew(i,j,k,URHO) = rho;
+          snew(i,j,k,UMX) = qf(i,j,k,1);
+          snew(i,j,k,UMY) = qf(i,j,k,2);
+          snew(i,j,k,UMZ) = qf(i,j,k,3);
+          snew(i,j,k,UTEMP) = temp;
+
+          snew(i,j,k,UEINT) = rho * eos_state.e;
+          snew(i,j,k,UEDEN) = snew(i,j,k,UEINT) +
+            0.5_rt * (qf(i,j,k,1) * qf(i,j,k,1) +
+                      qf(i,j,k,2) * qf(i,j,k,2) +
+                      qf(i,j,k,3) * qf(i,j,k,3)) / rho;
+
+          // advected quantities, species and auxiliary data are contiguous
+          for (int n = UFA; n < UFX + NumAux; ++n) {
+            snew(i,j,k,n) = sfp(i,j,k,n) * rho_old_inv * rho;
+          }
+        });
+      }
+    }
+
+    return;
+  }
+
   MultiFab mask(grids,dmap,1,ngrow);
   mask.setVal(-1.0,ngrow);
   mask.setVal( 0.0,0);
@@ -2683,9 +3065,6 @@ void Radiation::filter_prim(int level, MultiFab& State)
       }
   }
 
-  FillPatchIterator fpi(*castro,State,ngrow,time,State_Type,0,ncomp);
-  MultiFab& S_fp = fpi.get_mf();
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -2706,3 +3085,261 @@ void Radiation::filter_prim(int level, MultiFab& State)
                    &time, &level);
   }
 }
+
+
+bool Radiation::subcycle_skip_update(int level, MultiFab& S_new, Real delta_t)
+{
+  if (!subcycle_active(level)) {
+    return false;
+  }
+
+  BL_PROFILE("Radiation::subcycle_skip_update");
+
+  Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
+  MultiFab& Er_new = castro->get_new_data(Rad_Type);
+
+  if (subcycle_rate[level] == nullptr) {
+    subcycle_rate[level].reset(new MultiFab(castro->boxArray(), castro->DistributionMap(), nGroups+1, 0));
+    subcycle_ref[level].reset(new MultiFab(castro->boxArray(), castro->DistributionMap(), nGroups+1, 0));
+    subcycle_valid[level] = 0;
+  }
+
+  MultiFab& rate = *subcycle_rate[level];
+  const MultiFab& ref = *subcycle_ref[level];
+
+  const int ngroups = nGroups;
+
+  bool skip = subcycle_valid[level] && subcycle_skipped[level] < subcycle_max - 1;
+
+  if (skip) {
+
+    // The largest relative change of the total radiation energy and
+    // of the temperature since the last implicit update, and whether
+    // the old rates would make Er or the internal energy nonpositive
+    // anywhere.
+
+    ReduceOps<ReduceOpMax, ReduceOpMax> reduce_op;
+    ReduceData<Real, Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(Er_new, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+      const Box& bx = mfi.tilebox();
+
+      auto Er = Er_new.const_array(mfi);
+      auto S = S_new.const_array(mfi);
+      auto dot = rate.const_array(mfi);
+      auto old = ref.const_array(mfi);
+
+      reduce_op.eval(bx, reduce_data,
+      [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
+      {
+        Real E = 0.0_rt;
+        Real E_ref = 0.0_rt;
+        Real bad = 0.0_rt;
+
+        for (int g = 0; g < ngroups; ++g) {
+          E += Er(i,j,k,g);
+          E_ref += old(i,j,k,g);
+          if (Er(i,j,k,g) + dot(i,j,k,g) * delta_t < 0.0_rt) {
+            bad = 1.0_rt;
+          }
+        }
+
+        if (S(i,j,k,UEINT) + dot(i,j,k,ngroups) * delta_t <= 0.0_rt) {
+          bad = 1.0_rt;
+        }
+
+        Real change = std::abs(E - E_ref) / amrex::max(E_ref, 1.e-50_rt);
+        change = amrex::max(change, std::abs(S(i,j,k,UTEMP) - old(i,j,k,ngroups)) /
+                                    amrex::max(old(i,j,k,ngroups), small_temp));
+
+        return {change, bad};
+      });
+    }
+
+    ReduceTuple hv = reduce_data.value();
+    Real result[2] = {amrex::get<0>(hv), amrex::get<1>(hv)};
+    ParallelDescriptor::ReduceRealMax(result, 2);
+
+    skip = result[0] <= subcycle_tol && result[1] == 0.0_rt;
+
+    if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
+      std::cout << "Radiation subcycling: relative change of Er and T = " << result[0]
+                << (skip ? ", implicit update skipped" : ", implicit update taken") << std::endl;
+    }
+  }
+
+  if (skip) {
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(Er_new, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+      const Box& bx = mfi.tilebox();
+
+      auto Er = Er_new.array(mfi);
+      auto S = S_new.array(mfi);
+      auto dot = rate.const_array(mfi);
+
+      amrex::ParallelFor(bx,
+      [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+      {
+        for (int g = 0; g < ngroups; ++g) {
+          Er(i,j,k,g) += dot(i,j,k,g) * delta_t;
+        }
+
+        Real drhoe = dot(i,j,k,ngroups) * delta_t;
+        S(i,j,k,UEINT) += drhoe;
+        S(i,j,k,UEDEN) += drhoe;
+      });
+    }
+
+    subcycle_skipped[level] += 1;
+
+    return true;
+  }
+
+  // Save the state the rates of the coming update are measured from.
+
+  MultiFab::Copy(rate, Er_new, 0, 0, nGroups, 0);
+  MultiFab::Copy(rate, S_new, UEINT, nGroups, 1, 0);
+
+  subcycle_skipped[level] = 0;
+
+  return false;
+}
+
+void Radiation::subcycle_save_rates(int level, const MultiFab& S_new, Real delta_t)
+{
+  if (!subcycle_active(level)) {
+    return;
+  }
+
+  BL_PROFILE("Radiation::subcycle_save_rates");
+
+  Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
+  const MultiFab& Er_new = castro->get_new_data(Rad_Type);
+
+  MultiFab& rate = *subcycle_rate[level];
+  MultiFab& ref = *subcycle_ref[level];
+
+  const int ngroups = nGroups;
+  const Real dtinv = 1.0_rt / delta_t;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  for (MFIter mfi(Er_new, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const Box& bx = mfi.tilebox();
+
+    auto Er = Er_new.const_array(mfi);
+    auto S = S_new.const_array(mfi);
+    auto dot = rate.array(mfi);
+    auto old = ref.array(mfi);
+
+    amrex::ParallelFor(bx,
+    [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
+    {
+      for (int g = 0; g < ngroups; ++g) {
+        dot(i,j,k,g) = (Er(i,j,k,g) - dot(i,j,k,g)) * dtinv;
+        old(i,j,k,g) = Er(i,j,k,g);
+      }
+
+      dot(i,j,k,ngroups) = (S(i,j,k,UEINT) - dot(i,j,k,ngroups)) * dtinv;
+      old(i,j,k,ngroups) = S(i,j,k,UTEMP);
+    });
+  }
+
+  subcycle_valid[level] = 1;
+}
+
+void Radiation::composite_solver_setup(int crse_level)
+{
+  const int fine_level = parent->finestLevel();
+
+  bool rebuild = (composite_solver == nullptr ||
+                  static_cast<int>(composite_grids.size()) != fine_level + 1);
+
+  for (int lev = crse_level; lev <= fine_level && !rebuild; ++lev) {
+    if (composite_grids[lev] != parent->boxArray(lev) ||
+        composite_dmap[lev] != parent->DistributionMap(lev)) {
+      rebuild = true;
+    }
+  }
+
+  if (!rebuild) {
+    return;
+  }
+
+  BL_PROFILE("Radiation::composite_solver_setup");
+
+  if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
+    std::cout << "Building the composite radiation solver for levels "
+              << crse_level << " to " << fine_level << std::endl;
+  }
+
+  composite_solver.reset();
+
+  composite_grids.resize(fine_level + 1);
+  composite_dmap.resize(fine_level + 1);
+  composite_bd.resize(fine_level + 1);
+
+  Vector<MGRadBndry*> bd;
+
+  for (int lev = crse_level; lev <= fine_level; ++lev) {
+    composite_grids[lev] = parent->boxArray(lev);
+    composite_dmap[lev] = parent->DistributionMap(lev);
+    composite_bd[lev].reset(new MGRadBndry(composite_grids[lev], composite_dmap[lev],
+                                           nGroups, parent->Geom(lev)));
+    bd.push_back(composite_bd[lev].get());
+  }
+
+  composite_solver.reset(new RadSolve(parent, crse_level, fine_level, bd));
+}
+
+bool Radiation::plotvar_due(int level) const
+{
+  if (plotvar_every_step) {
+    return true;
+  }
+
+  // Amr counts a coarse step after the level 0 advance, which is where
+  // the level 0 update runs unless the composite update does it at
+  // the end of the coarse step.  cumTime is the start of the coarse
+  // step throughout.
+
+  int nstep = parent->levelSteps(0);
+  if (level == 0 && !composite_active()) {
+    nstep += 1;
+  }
+
+  const Real dt0 = parent->dtLevel(0);
+  const Real time = parent->cumTime() + dt0;
+
+  // A step ending within roundoff of a plot time counts as reaching it.
+  const Real eps = 1.e-6_rt * dt0;
+
+  if (plot_int_amr > 0 && nstep % plot_int_amr == 0) {
+    return true;
+  }
+
+  if (plot_per_amr > 0.0 &&
+      std::floor((time + eps) / plot_per_amr) > std::floor((time - dt0 + eps) / plot_per_amr)) {
+    return true;
+  }
+
+  // the final plotfile of the run
+
+  if (max_step_amr >= 0 && nstep >= max_step_amr) {
+    return true;
+  }
+
+  if (stop_time_amr >= 0.0 && time + eps >= stop_time_amr) {
+    return true;
+  }
+
+  return false;
+}
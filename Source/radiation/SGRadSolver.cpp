@@ -373,19 +373,22 @@ void Radiation::single_group_update(int level, int iteration, int ncycle)
   // update dflux[level] (== dflux_old)
   MultiFab::Copy(dflux_old, dflux_new, 0, 0, 1, 0);
 
-  if (plot_lambda) {
+  // The plot variables are only needed if this step ends with a plotfile.
+  const bool save_plotvar = plotvar_due(level);
+
+  if (save_plotvar && plot_lambda) {
       save_lambda_in_plotvar(level, lambda);
   }
 
-  if (plot_kappa_p) {
+  if (save_plotvar && plot_kappa_p) {
       MultiFab::Copy(*plotvar[level], fkp, 0, icomp_kp, 1, 0);
   }
 
-  if (plot_kappa_r) {
+  if (save_plotvar && plot_kappa_r) {
       MultiFab::Copy(*plotvar[level], kappa_r, 0, icomp_kr, 1, 0);
   }
 
-  if (plot_lab_Er || plot_lab_flux || plot_com_flux) {
+  if (save_plotvar && (plot_lab_Er || plot_lab_flux || plot_com_flux)) {
       MultiFab flx(grids, dmap, BL_SPACEDIM, 0);
       solver->levelFluxFaceToCenter(level, Ff_new, flx, 0);
 
@@ -20,35 +20,123 @@ Castro::do_energy_diagnostics()
   int v = verbose;
   v = (do_radiation && radiation->verbose > v) ? radiation->verbose : v;
 
-  if (do_radiation && (v > 2 || (level == 0 && v > 0))) {
-    Real prev_time = state[State_Type].prevTime();
-    Real dt = parent->dtLevel(level);
+  if (!(v > 2 || (level == 0 && v > 0))) {
+    return;
+  }
+
+  Real prev_time = state[State_Type].prevTime();
+  Real dt = parent->dtLevel(level);
+  Real time = prev_time + dt;
+
+  // The sums are taken at the new time of this level. If every level
+  // has reached that time, the mass, the fluid energy and the radiation
+  // energy are summed in one pass over each level on the new data, and
+  // reduced across the ranks together. Otherwise (for a fine level in
+  // the middle of a subcycle) the coarser data is interpolated in time.
+
+  bool synchronized = true;
+  for (int lev = 0; lev <= finest_level; lev++) {
+    Real t_lev = getLevel(lev).get_state_data(State_Type).curTime();
+    if (std::abs(t_lev - time) > 1.e-12_rt * std::max(std::abs(time), dt)) {
+      synchronized = false;
+    }
+  }
+
+  Real m = 0.0, s = 0.0, r = 0.0;
+
+  if (synchronized) {
+
+    const int nrad = do_radiation ? Radiation::nGroups : 0;
 
-    Real m = 0.0, s = 0.0, r = 0.0, rr = 0.0, rry = 0.0;
+    Real sums[3] = {0.0, 0.0, 0.0};
 
     for (int lev = 0; lev <= finest_level; lev++) {
-      m += getLevel(lev).volWgtSum("density", prev_time + dt);
-      s += getLevel(lev).volWgtSum("rho_E",   prev_time + dt);
-      if (!Radiation::do_multigroup) {
-          r += getLevel(lev).volWgtSum("rad", prev_time + dt);
+      Castro& ca_lev = getLevel(lev);
+
+      const MultiFab& S_new = ca_lev.get_new_data(State_Type);
+      const MultiFab* Er_new = do_radiation ? &ca_lev.get_new_data(Rad_Type) : nullptr;
+      const MultiFab* mask = (lev < finest_level) ? &getLevel(lev+1).build_fine_mask() : nullptr;
+
+      ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_op;
+      ReduceData<Real, Real, Real> reduce_data(reduce_op);
+      using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      for (MFIter mfi(S_new, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+      {
+        const Box& box = mfi.tilebox();
+
+        auto const& sarr = S_new.const_array(mfi);
+        auto const& vol = ca_lev.volume.const_array(mfi);
+        Array4<Real const> const Er = Er_new ? Er_new->const_array(mfi) : Array4<Real const>{};
+        Array4<Real const> const msk = mask ? mask->const_array(mfi) : Array4<Real const>{};
+        const bool use_mask = mask != nullptr;
+
+        reduce_op.eval(box, reduce_data,
+        [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+          Real w = vol(i,j,k);
+          if (use_mask) {
+            w *= msk(i,j,k);
+          }
+
+          Real er = 0.0;
+          for (int g = 0; g < nrad; g++) {
+            er += Er(i,j,k,g);
+          }
+
+          return {sarr(i,j,k,URHO) * w, sarr(i,j,k,UEDEN) * w, er * w};
+        });
       }
-      else {
+
+      ReduceTuple hv = reduce_data.value();
+      sums[0] += amrex::get<0>(hv);
+      sums[1] += amrex::get<1>(hv);
+      sums[2] += amrex::get<2>(hv);
+    }
+
+    ParallelDescriptor::ReduceRealSum(sums, 3);
+
+    m = sums[0];
+    s = sums[1];
+    r = sums[2];
+
+  }
+  else {
+
+    for (int lev = 0; lev <= finest_level; lev++) {
+      m += getLevel(lev).volWgtSum("density", time);
+      s += getLevel(lev).volWgtSum("rho_E",   time);
+      if (do_radiation) {
+        if (!Radiation::do_multigroup) {
+          r += getLevel(lev).volWgtSum("rad", time);
+        }
+        else {
           char rad_name[10];
           for (int igroup = 0; igroup < Radiation::nGroups; igroup++) {
-              sprintf(rad_name, "rad%d", igroup);
-              r += getLevel(lev).volWgtSum(rad_name, prev_time + dt);
+            sprintf(rad_name, "rad%d", igroup);
+            r += getLevel(lev).volWgtSum(rad_name, time);
           }
+        }
       }
-      if (lev < finest_level) {
-          // If using deferred sync, also include flux register energy
-          FluxRegister* sync_flux = radiation->consRegister(lev + 1);
-          if (sync_flux) {
-              for (int k = 0; k < Radiation::nGroups; k++) {
-                  // Minus sign in following relates to FluxRegister defn:
-                  Real tmp = -sync_flux->SumReg(k) * parent->dtLevel(lev);
-                  rr  += tmp;
-              }
-          }
+    }
+
+  }
+
+  if (do_radiation) {
+    Real rr = 0.0, rry = 0.0;
+
+    for (int lev = 0; lev < finest_level; lev++) {
+      // If using deferred sync, also include flux register energy
+      FluxRegister* sync_flux = radiation->consRegister(lev + 1);
+      if (sync_flux) {
+        for (int k = 0; k < Radiation::nGroups; k++) {
+          // Minus sign in following relates to FluxRegister defn:
+          Real tmp = -sync_flux->SumReg(k) * parent->dtLevel(lev);
+          rr  += tmp;
+        }
       }
     }
 
@@ -85,15 +173,7 @@ Castro::do_energy_diagnostics()
       cout.precision(oldprec);
     }
   }
-  else if (v > 2 || (level == 0 && v > 0)) {
-    Real prev_time = state[State_Type].prevTime();
-    Real dt = parent->dtLevel(level);
-
-    Real m = 0.0, s = 0.0;
-    for (int lev = 0; lev <= finest_level; lev++) {
-      m += getLevel(lev).volWgtSum("density", prev_time + dt);
-      s += getLevel(lev).volWgtSum("rho_E",   prev_time + dt);
-    }
+  else {
     if (ParallelDescriptor::IOProcessor()) {
       int oldprec = cout.precision(20);
       cout << "Integrated  Fluid   Mass  is " << m << '\n';
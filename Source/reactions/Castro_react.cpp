@@ -1,6 +1,8 @@
 
 #include <Castro.H>
 #include <Castro_F.H>
+#include <Castro_util.H>
+#include <perf_counters.H>
 
 using std::string;
 using namespace amrex;
@@ -11,6 +13,7 @@ bool
 Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
 {
     BL_PROFILE("Castro::react_state()");
+    CASTRO_PERF_REGION(perf_react);
 
     // Sanity check: should only be in here if we're doing CTU.
 
@@ -69,7 +72,7 @@ Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-    for (MFIter mfi(s, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for (MFIter mfi(s, tile_size(tile_family_react)); mfi.isValid(); ++mfi)
     {
 
         const Box& bx = mfi.growntilebox(ng);
@@ -105,14 +108,16 @@ Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
                 burn_state.T   = U(i,j,k,UTEMP);
                 burn_state.e   = 0.0_rt; // Energy generated by the burn
 
-                for (int n = 0; n < NumSpec; ++n) {
+                unroll_for<NumSpec>([&] (int n)
+                {
                     burn_state.xn[n] = U(i,j,k,UFS+n) * rhoInv;
-                }
+                });
 
 #if NAUX_NET > 0
-                for (int n = 0; n < NumAux; ++n) {
+                unroll_for<NumAux>([&] (int n)
+                {
                     burn_state.aux[n] = U(i,j,k,UFX+n) * rhoInv;
-                }
+                });
 #endif
 
                 // Ensure we start with no RHS or Jacobian calls registered.
@@ -144,13 +149,15 @@ Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
                     // not have the same number of ghost cells.
 
                     if (reactions.contains(i,j,k)) {
-                        for (int n = 0; n < NumSpec; ++n) {
+                        unroll_for<NumSpec>([&] (int n)
+                        {
                             reactions(i,j,k,n) = U(i,j,k,URHO) * (burn_state.xn[n] - U(i,j,k,UFS+n) * rhoInv) / dt;
-                        }
+                        });
 #if NAUX_NET > 0
-                        for (int n = 0; n < NumAux; ++n) {
+                        unroll_for<NumAux>([&] (int n)
+                        {
                             reactions(i,j,k,n+NumSpec) = U(i,j,k,URHO) * (burn_state.aux[n] - U(i,j,k,UFX+n) * rhoInv) / dt;
-                        }
+                        });
 #endif
                         reactions(i,j,k,NumSpec+NumAux  ) = U(i,j,k,URHO) * burn_state.e / dt;
                         reactions(i,j,k,NumSpec+NumAux+1) = amrex::max(1.0_rt, static_cast<Real>(burn_state.n_rhs + 2 * burn_state.n_jac));
@@ -181,13 +188,15 @@ Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
         [=] AMREX_GPU_HOST_DEVICE (int i, int j, int k)
         {
             if (U.contains(i,j,k) && reactions.contains(i,j,k)) {
-                for (int n = 0; n < NumSpec; ++n) {
+                unroll_for<NumSpec>([&] (int n)
+                {
                     U(i,j,k,UFS+n) += reactions(i,j,k,n) * dt;
-                }
+                });
 #if NAUX_NET > 0
-                for (int n = 0; n < NumAux; ++n) {
+                unroll_for<NumAux>([&] (int n)
+                {
                     U(i,j,k,UFX+n) += reactions(i,j,k,n+NumSpec) * dt;
-                }
+                });
 #endif
                 U(i,j,k,UEINT) += reactions(i,j,k,NumSpec+NumAux) * dt;
                 U(i,j,k,UEDEN) += reactions(i,j,k,NumSpec+NumAux) * dt;
@@ -203,6 +212,8 @@ Castro::react_state(MultiFab& s, MultiFab& r, Real time, Real dt)
       burn_success = 0;
     }
 
+    record_tile_time(tile_family_react, ParallelDescriptor::second() - strt_time);
+
     ParallelDescriptor::ReduceIntMin(burn_success);
 
     if (print_update_diagnostics) {
@@ -261,6 +272,7 @@ Castro::react_state(Real time, Real dt)
     // S_new with the combined effects of advection and reactions.
 
     BL_PROFILE("Castro::react_state()");
+    CASTRO_PERF_REGION(perf_react);
 
     // Sanity check: should only be in here if we're doing simplified SDC.
 
@@ -310,7 +322,7 @@ Castro::react_state(Real time, Real dt)
 
     using ReduceTuple = typename decltype(reduce_data)::Type;
 
-    for (MFIter mfi(S_new, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for (MFIter mfi(S_new, tile_size(tile_family_react)); mfi.isValid(); ++mfi)
     {
 
         const Box& bx = mfi.growntilebox(ng);
@@ -461,6 +473,8 @@ Castro::react_state(Real time, Real dt)
 
     if (burn_failed != 0.0) burn_success = 0;
 
+    record_tile_time(tile_family_react, ParallelDescriptor::second() - strt_time);
+
     ParallelDescriptor::ReduceIntMin(burn_success);
 
     if (ng > 0) {
@@ -12,18 +12,15 @@ Castro::construct_old_rotation_source(MultiFab& source, MultiFab& state_in, Real
 
     const Real strt_time = ParallelDescriptor::second();
 
-    MultiFab& phirot_old = get_old_data(PhiRot_Type);
-
-    // Fill the rotation data.
+    // Fill the rotation data. Without rotation there is no old-time
+    // data to fill; see old_data_needed().
 
     if (!do_rotation) {
-
-        phirot_old.setVal(0.0);
-
         return;
-
     }
 
+    MultiFab& phirot_old = get_old_data(PhiRot_Type);
+
     fill_rotation_field(phirot_old, state_in, time);
 
     const Real *dx = geom.CellSize();
@@ -68,8 +65,6 @@ Castro::construct_new_rotation_source(MultiFab& source, MultiFab& state_old, Mul
 
     const Real strt_time = ParallelDescriptor::second();
 
-    MultiFab& phirot_old = get_old_data(PhiRot_Type);
-
     MultiFab& phirot_new = get_new_data(PhiRot_Type);
 
     // Fill the rotation data.
@@ -82,6 +77,8 @@ Castro::construct_new_rotation_source(MultiFab& source, MultiFab& state_old, Mul
 
     }
 
+    MultiFab& phirot_old = get_old_data(PhiRot_Type);
+
     fill_rotation_field(phirot_new, state_new, time);
 
     // Now do corrector part of rotation source term update